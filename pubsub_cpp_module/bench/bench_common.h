@@ -0,0 +1,166 @@
+// bench_common.h
+// Shared helpers for the benchmark executables: argument parsing, latency percentiles
+// and CSV/JSON result files.
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace bench {
+
+using Clock = std::chrono::steady_clock;
+
+inline double elapsed_ns(Clock::time_point t0, Clock::time_point t1) {
+    return std::chrono::duration<double, std::nano>(t1 - t0).count();
+}
+
+// Spins (yielding) until `pred` holds or `timeout` passes. Returns pred().
+template <class Pred>
+bool wait_for(Pred pred, std::chrono::milliseconds timeout) {
+    const auto deadline = Clock::now() + timeout;
+    while (!pred()) {
+        if (Clock::now() >= deadline) return pred();
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+// Command line: --iters N --warmup N --seconds S --sizes a,b,c --out DIR --same-node
+struct Args {
+    int iters = 10000;
+    int warmup = 1000;
+    double seconds = 2.0;
+    std::vector<size_t> sizes;
+    std::string out = ".";
+    bool same_node = false;
+
+    Args(int argc, char** argv, std::vector<size_t> default_sizes, int default_iters = 10000,
+         int default_warmup = 1000)
+        : iters(default_iters), warmup(default_warmup), sizes(std::move(default_sizes)) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string a = argv[i];
+            auto next = [&]() -> std::string { return i + 1 < argc ? argv[++i] : ""; };
+            if (a == "--iters") iters = std::atoi(next().c_str());
+            else if (a == "--warmup") warmup = std::atoi(next().c_str());
+            else if (a == "--seconds") seconds = std::atof(next().c_str());
+            else if (a == "--out") out = next();
+            else if (a == "--same-node") same_node = true;
+            else if (a == "--sizes") {
+                sizes.clear();
+                std::stringstream ss(next());
+                std::string tok;
+                while (std::getline(ss, tok, ',')) sizes.push_back(std::strtoull(tok.c_str(), nullptr, 10));
+            } else {
+                std::fprintf(stderr, "unknown argument: %s\n", a.c_str());
+                std::exit(2);
+            }
+        }
+    }
+};
+
+struct LatencySummary {
+    size_t samples = 0;
+    double mean = 0, min = 0, p50 = 0, p90 = 0, p99 = 0, p999 = 0, max = 0;  // nanoseconds
+};
+
+inline LatencySummary summarize(std::vector<double> ns) {
+    LatencySummary s;
+    s.samples = ns.size();
+    if (ns.empty()) return s;
+    std::sort(ns.begin(), ns.end());
+    auto pct = [&](double p) { return ns[std::min(ns.size() - 1, static_cast<size_t>(p * (ns.size() - 1) + 0.5))]; };
+    double sum = 0;
+    for (double v : ns) sum += v;
+    s.mean = sum / ns.size();
+    s.min = ns.front();
+    s.p50 = pct(0.50);
+    s.p90 = pct(0.90);
+    s.p99 = pct(0.99);
+    s.p999 = pct(0.999);
+    s.max = ns.back();
+    return s;
+}
+
+// Rows of named fields, written as a table on stdout and as <out>/<name>.csv / .json.
+class Report {
+public:
+    explicit Report(std::string name) : _name(std::move(name)) {}
+
+    Report& row() { _rows.emplace_back(); return *this; }
+    Report& add(const std::string& col, const std::string& v) { return put(col, v, false); }
+    Report& add(const std::string& col, const char* v) { return put(col, v, false); }
+    Report& add(const std::string& col, double v) {
+        char buf[64];
+        std::snprintf(buf, sizeof buf, "%.3f", v);
+        return put(col, buf, true);
+    }
+    Report& add(const std::string& col, uint64_t v) { return put(col, std::to_string(v), true); }
+    Report& add(const std::string& col, int v) { return put(col, std::to_string(v), true); }
+    Report& add_latency(const LatencySummary& s) {
+        return add("samples", static_cast<uint64_t>(s.samples))
+              .add("mean_us", s.mean / 1e3).add("min_us", s.min / 1e3)
+              .add("p50_us", s.p50 / 1e3).add("p90_us", s.p90 / 1e3)
+              .add("p99_us", s.p99 / 1e3).add("p999_us", s.p999 / 1e3)
+              .add("max_us", s.max / 1e3);
+    }
+
+    void write(const std::string& dir) const {
+        print();
+        const std::string base = dir + "/" + _name;
+        std::ofstream csv(base + ".csv");
+        std::ofstream json(base + ".json");
+        if (_rows.empty()) return;
+        for (size_t i = 0; i < _rows[0].size(); ++i) csv << (i ? "," : "") << _rows[0][i].col;
+        csv << "\n";
+        for (auto& r : _rows) {
+            for (size_t i = 0; i < r.size(); ++i) csv << (i ? "," : "") << r[i].text;
+            csv << "\n";
+        }
+        json << "{\"benchmark\":\"" << _name << "\",\"results\":[\n";
+        for (size_t j = 0; j < _rows.size(); ++j) {
+            json << "  {";
+            for (size_t i = 0; i < _rows[j].size(); ++i) {
+                const Field& f = _rows[j][i];
+                json << (i ? "," : "") << "\"" << f.col << "\":";
+                if (f.numeric) json << f.text; else json << "\"" << f.text << "\"";
+            }
+            json << "}" << (j + 1 < _rows.size() ? "," : "") << "\n";
+        }
+        json << "]}\n";
+        std::printf("wrote %s.csv and %s.json\n", base.c_str(), base.c_str());
+    }
+
+    void print() const {
+        if (_rows.empty()) return;
+        for (auto& f : _rows[0]) std::printf("%14s", f.col.c_str());
+        std::printf("\n");
+        for (auto& r : _rows) {
+            for (auto& f : r) std::printf("%14s", f.text.c_str());
+            std::printf("\n");
+        }
+    }
+
+private:
+    struct Field {
+        std::string col;
+        std::string text;
+        bool numeric;
+    };
+
+    Report& put(const std::string& col, const std::string& text, bool numeric) {
+        _rows.back().push_back(Field{col, text, numeric});
+        return *this;
+    }
+
+    std::string _name;
+    std::vector<std::vector<Field>> _rows;
+};
+
+} // namespace bench
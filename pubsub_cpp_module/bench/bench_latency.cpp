@@ -0,0 +1,141 @@
+// bench_latency.cpp
+// Ping-pong round-trip latency between two in-process nodes (or one, with --same-node),
+// once through the C++ Node and once through the ZU_* C ABI.
+// The first 8 bytes of every ping carry its sequence number; the pong echoes it back.
+#include "bench_common.h"
+#include "node.h"
+#include "zenoh_unity_wrapper.h"
+#include <atomic>
+#include <cstring>
+#include <memory>
+
+using ubicoders_zenoh::BytesView;
+using ubicoders_zenoh::Node;
+
+namespace {
+
+const char* kPingKey = "bench/latency/ping";
+const char* kPongKey = "bench/latency/pong";
+
+uint64_t read_seq(const uint8_t* data, size_t len) {
+    uint64_t seq = 0;
+    if (len >= sizeof(seq)) std::memcpy(&seq, data, sizeof(seq));
+    return seq;
+}
+
+// Sends pings through `send` and waits for the echo of each one.
+template <class Send>
+std::vector<double> ping_pong(const bench::Args& args, size_t size, std::atomic<uint64_t>& last_pong, Send send) {
+    std::vector<uint8_t> payload(std::max(size, sizeof(uint64_t)), 0x5A);
+    std::vector<double> rtts;
+    rtts.reserve(args.iters);
+
+    // Wait until the two sides have discovered each other
+    uint64_t seq = 0;
+    bool connected = false;
+    const auto give_up = bench::Clock::now() + std::chrono::seconds(10);
+    while (!connected && bench::Clock::now() < give_up) {
+        ++seq;
+        std::memcpy(payload.data(), &seq, sizeof(seq));
+        send(payload);
+        connected = bench::wait_for([&] { return last_pong.load() == seq; }, std::chrono::milliseconds(50));
+    }
+    if (!connected) {
+        std::fprintf(stderr, "no pong received; are the sessions connected?\n");
+        return rtts;
+    }
+
+    for (int i = 0; i < args.warmup + args.iters; ++i) {
+        ++seq;
+        std::memcpy(payload.data(), &seq, sizeof(seq));
+        const auto t0 = bench::Clock::now();
+        send(payload);
+        if (!bench::wait_for([&] { return last_pong.load(std::memory_order_acquire) >= seq; },
+                             std::chrono::seconds(1)))
+            continue;  // lost; not counted
+        const auto t1 = bench::Clock::now();
+        if (i >= args.warmup) rtts.push_back(bench::elapsed_ns(t0, t1));
+    }
+    return rtts;
+}
+
+std::vector<double> run_node(const bench::Args& args, size_t size) {
+    std::atomic<uint64_t> last_pong{0};
+    ubicoders_zenoh::NodeOptions own;
+    own.share_session = false;  // two nodes means two sessions here
+    auto pinger = std::make_unique<Node>("bench_latency_ping", own);
+    std::unique_ptr<Node> ponger_owned = args.same_node ? nullptr : std::make_unique<Node>("bench_latency_pong", own);
+    Node& ponger = args.same_node ? *pinger : *ponger_owned;
+
+    auto pong_pub = ponger.declare_publisher(kPongKey);
+    ponger.create_view_subscriber(kPingKey, [pong_pub](const std::string&, BytesView v) {
+        pong_pub->publish(v.data, v.size);
+    });
+    pinger->create_view_subscriber(kPongKey, [&](const std::string&, BytesView v) {
+        last_pong.store(read_seq(v.data, v.size), std::memory_order_release);
+    });
+    auto ping_pub = pinger->declare_publisher(kPingKey);
+
+    auto rtts = ping_pong(args, size, last_pong, [&](const std::vector<uint8_t>& p) {
+        ping_pub->publish(p.data(), p.size());
+    });
+    pinger->shutdown();
+    if (ponger_owned) ponger_owned->shutdown();
+    return rtts;
+}
+
+struct ZuPonger {
+    ZU_PublisherHandle pub = 0;
+};
+
+void ZU_CALL zu_on_ping(const char*, const uint8_t* data, int32_t len, void* user) {
+    ZU_PublishTo(static_cast<ZuPonger*>(user)->pub, data, len);
+}
+
+void ZU_CALL zu_on_pong(const char*, const uint8_t* data, int32_t len, void* user) {
+    static_cast<std::atomic<uint64_t>*>(user)->store(read_seq(data, static_cast<size_t>(len)),
+                                                     std::memory_order_release);
+}
+
+std::vector<double> run_zu(const bench::Args& args, size_t size) {
+    std::atomic<uint64_t> last_pong{0};
+    ZuPonger ponger_ctx;
+    ZU_NodeOptions own = {};
+    own.private_session = 1;
+    ZU_NodeHandle pinger = ZU_CreateNodeWithOptions("bench_latency_zu_ping", &own);
+    ZU_NodeHandle ponger = args.same_node ? pinger : ZU_CreateNodeWithOptions("bench_latency_zu_pong", &own);
+
+    ponger_ctx.pub = ZU_DeclarePublisher(ponger, kPongKey);
+    ZU_CreateSubscriber(ponger, kPingKey, zu_on_ping, &ponger_ctx);
+    ZU_CreateSubscriber(pinger, kPongKey, zu_on_pong, &last_pong);
+    ZU_PublisherHandle ping_pub = ZU_DeclarePublisher(pinger, kPingKey);
+
+    auto rtts = ping_pong(args, size, last_pong, [&](const std::vector<uint8_t>& p) {
+        ZU_PublishTo(ping_pub, p.data(), static_cast<int32_t>(p.size()));
+    });
+
+    ZU_UndeclarePublisher(ping_pub);
+    ZU_UndeclarePublisher(ponger_ctx.pub);
+    if (ponger != pinger) ZU_DestroyNode(ponger);
+    ZU_DestroyNode(pinger);
+    return rtts;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Args args(argc, argv, {64, 1024, 16384, 262144});
+    bench::Report report("bench_latency");
+
+    for (const char* api : {"node", "zu"}) {
+        for (size_t size : args.sizes) {
+            const bool zu = std::strcmp(api, "zu") == 0;
+            auto rtts = zu ? run_zu(args, size) : run_node(args, size);
+            report.row().add("api", api).add("bytes", static_cast<uint64_t>(size))
+                  .add("lost", static_cast<uint64_t>(args.iters - rtts.size()))
+                  .add_latency(bench::summarize(std::move(rtts)));
+        }
+    }
+    report.write(args.out);
+    return 0;
+}
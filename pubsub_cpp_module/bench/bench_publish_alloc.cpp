@@ -0,0 +1,89 @@
+// bench_publish_alloc.cpp
+// Counts C++ heap allocations and copied bytes per published message for each publish path.
+// Only allocations made through operator new are visible (zenoh's own Rust allocations are not),
+// and on Windows the DLL keeps its own heap, so run this on Linux.
+#include "node.h"
+#include "zenoh_unity_wrapper.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+static std::atomic<uint64_t> g_allocs{0};
+static std::atomic<uint64_t> g_alloc_bytes{0};
+
+void* operator new(std::size_t n) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    g_alloc_bytes.fetch_add(n, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+void noop_release(const uint8_t*, void*) {}
+
+void run(const char* label, int iters, size_t payload, const std::function<void()>& publish_once) {
+    publish_once();  // warm-up: declares the publisher
+    const uint64_t a0 = g_allocs.load(), b0 = g_alloc_bytes.load();
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iters; ++i) publish_once();
+    const auto t1 = std::chrono::steady_clock::now();
+    const double allocs = double(g_allocs.load() - a0) / iters;
+    const double bytes  = double(g_alloc_bytes.load() - b0) / iters;
+    const double ns     = std::chrono::duration<double, std::nano>(t1 - t0).count() / iters;
+    std::printf("%-28s %8zu %12.2f %14.1f %12.1f\n", label, payload, allocs, bytes, ns);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int iters = argc > 1 ? std::atoi(argv[1]) : 10000;
+    const size_t sizes[] = {64, 4096, 65536};
+
+    ubicoders_zenoh::Node node("bench_publish_alloc");
+    ZU_NodeHandle zu = ZU_CreateNode("bench_publish_alloc_zu");
+    const std::string key = "bench/publish_alloc";
+
+    std::printf("%-28s %8s %12s %14s %12s\n", "path", "bytes", "allocs/msg", "alloc_B/msg", "ns/msg");
+    for (size_t sz : sizes) {
+        std::vector<uint8_t> payload(sz, 0xAB);
+
+        // What ZU_Publish used to do: copy into a vector, then copy again into zenoh::Bytes
+        run("before: vector+Bytes copy", iters, sz, [&] {
+            std::vector<uint8_t> buf(payload.data(), payload.data() + payload.size());
+            node.publish(key, buf);
+        });
+        run("Node::publish(ptr,len)", iters, sz, [&] {
+            node.publish(key, payload.data(), payload.size());
+        });
+        run("Node::publish_borrowed", iters, sz, [&] {
+            node.publish_borrowed(key, payload.data(), payload.size(), nullptr);
+        });
+        auto handle = node.declare_publisher(key);
+        run("PublisherHandle::publish", iters, sz, [&] {
+            handle->publish(payload.data(), payload.size());
+        });
+        run("ZU_Publish", iters, sz, [&] {
+            ZU_Publish(zu, key.c_str(), payload.data(), static_cast<int32_t>(payload.size()));
+        });
+        run("ZU_PublishBorrowed", iters, sz, [&] {
+            ZU_PublishBorrowed(zu, key.c_str(), payload.data(), static_cast<int32_t>(payload.size()),
+                               noop_release, nullptr);
+        });
+        ZU_PublisherHandle zpub = ZU_DeclarePublisher(zu, key.c_str());
+        run("ZU_PublishTo", iters, sz, [&] {
+            ZU_PublishTo(zpub, payload.data(), static_cast<int32_t>(payload.size()));
+        });
+        ZU_UndeclarePublisher(zpub);
+    }
+
+    ZU_DestroyNode(zu);
+    return 0;
+}
@@ -0,0 +1,74 @@
+// bench_publish_mt.cpp
+// Multi-threaded ZU_Publish / ZU_PublishTo throughput on one node at 1, 4 and 16 threads.
+// Each thread publishes to its own key, so what is measured is the cost of the C API
+// (handle lookup, locking) rather than zenoh routing contention on a single key.
+#include "zenoh_unity_wrapper.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+enum class Path { ZU_Publish, ZU_PublishTo };
+
+double run(ZU_NodeHandle node, Path path, int threads, int iters, size_t payload) {
+    std::vector<std::string> keys;
+    std::vector<ZU_PublisherHandle> pubs;
+    for (int t = 0; t < threads; ++t) {
+        keys.push_back("bench/publish_mt/" + std::to_string(t));
+        pubs.push_back(ZU_DeclarePublisher(node, keys.back().c_str()));
+    }
+
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::vector<uint8_t> data(payload, static_cast<uint8_t>(t));
+            ready.fetch_add(1);
+            while (!go.load()) std::this_thread::yield();
+            for (int i = 0; i < iters; ++i) {
+                if (path == Path::ZU_Publish)
+                    ZU_Publish(node, keys[t].c_str(), data.data(), static_cast<int32_t>(data.size()));
+                else
+                    ZU_PublishTo(pubs[t], data.data(), static_cast<int32_t>(data.size()));
+            }
+        });
+    }
+    while (ready.load() != threads) std::this_thread::yield();
+    const auto t0 = std::chrono::steady_clock::now();
+    go.store(true);
+    for (auto& w : workers) w.join();
+    const auto t1 = std::chrono::steady_clock::now();
+
+    for (auto p : pubs) ZU_UndeclarePublisher(p);
+    const double secs = std::chrono::duration<double>(t1 - t0).count();
+    return double(threads) * iters / secs;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int iters = argc > 1 ? std::atoi(argv[1]) : 100000;
+    const size_t payload = argc > 2 ? static_cast<size_t>(std::atoi(argv[2])) : 64;
+
+    ZU_NodeHandle node = ZU_CreateNode("bench_publish_mt");
+    if (!node) { std::fprintf(stderr, "failed to create node\n"); return 1; }
+
+    std::printf("%-14s %8s %14s %12s\n", "path", "threads", "msgs/s", "ns/msg/thr");
+    for (Path path : {Path::ZU_Publish, Path::ZU_PublishTo}) {
+        for (int threads : {1, 4, 16}) {
+            const double rate = run(node, path, threads, iters, payload);
+            std::printf("%-14s %8d %14.0f %12.1f\n",
+                        path == Path::ZU_Publish ? "ZU_Publish" : "ZU_PublishTo",
+                        threads, rate, 1e9 * threads / rate);
+        }
+    }
+
+    ZU_DestroyNode(node);
+    return 0;
+}
@@ -0,0 +1,127 @@
+// bench_query.cpp
+// Query round-trip latency against a server declared through Node::create_view_server
+// and through ZU_CreateServer (deferred reply completed straight from the callback).
+// The client, in the same process, issues one get at a time either from a plain zenoh
+// session or through a querier declared with Node::declare_querier.
+#include "bench_common.h"
+#include "node.h"
+#include "zenoh_unity_wrapper.h"
+#include <atomic>
+#include <cstring>
+#include <memory>
+
+using ubicoders_zenoh::BytesView;
+using ubicoders_zenoh::Node;
+
+namespace {
+
+const char* kKey = "bench/query/echo";
+
+// One get at a time; returns the round trip in ns, or a negative value on error/timeout.
+double timed_get(const zenoh::Session& client, const std::vector<uint8_t>& payload) {
+    auto ok = std::make_shared<std::atomic<bool>>(false);
+    auto done = std::make_shared<std::atomic<bool>>(false);
+    zenoh::Session::GetOptions opts;
+    opts.payload = zenoh::Bytes(payload.data(), payload.size());
+    opts.timeout_ms = 1000;
+
+    const auto t0 = bench::Clock::now();
+    client.get(zenoh::KeyExpr(kKey), "",
+               [ok](const zenoh::Reply& r) { if (r.is_ok()) ok->store(true); },
+               [done]() { done->store(true, std::memory_order_release); },
+               std::move(opts));
+    bench::wait_for([&] { return done->load(std::memory_order_acquire); }, std::chrono::seconds(2));
+    const auto t1 = bench::Clock::now();
+    return ok->load() ? bench::elapsed_ns(t0, t1) : -1.0;
+}
+
+// Same through a declared querier
+double timed_get(const ubicoders_zenoh::QuerierHandle& querier, const std::vector<uint8_t>& payload) {
+    auto ok = std::make_shared<std::atomic<bool>>(false);
+    auto done = std::make_shared<std::atomic<bool>>(false);
+
+    const auto t0 = bench::Clock::now();
+    querier.get("", payload.data(), payload.size(),
+                [ok](bool is_ok, const std::string&, BytesView) { if (is_ok) ok->store(true); },
+                [done]() { done->store(true, std::memory_order_release); });
+    bench::wait_for([&] { return done->load(std::memory_order_acquire); }, std::chrono::seconds(2));
+    const auto t1 = bench::Clock::now();
+    return ok->load() ? bench::elapsed_ns(t0, t1) : -1.0;
+}
+
+template <class Get>
+std::vector<double> measure_with(const bench::Args& args, size_t size, Get get) {
+    std::vector<uint8_t> payload(size, 0x3C);
+    std::vector<double> rtts;
+
+    // Wait until the server is reachable
+    if (!bench::wait_for([&] { return get(payload) >= 0; }, std::chrono::seconds(10))) {
+        std::fprintf(stderr, "no reply; is the server reachable?\n");
+        return rtts;
+    }
+    for (int i = 0; i < args.warmup + args.iters; ++i) {
+        const double ns = get(payload);
+        if (ns >= 0 && i >= args.warmup) rtts.push_back(ns);
+    }
+    return rtts;
+}
+
+std::vector<double> measure(const bench::Args& args, size_t size, bool querier) {
+    if (querier) {
+        ubicoders_zenoh::NodeOptions own;
+        own.share_session = false;  // like the plain-session client, not the server's session
+        Node client("bench_query_client", own);
+        auto q = client.declare_querier(kKey, std::chrono::milliseconds(1000));
+        return measure_with(args, size, [&](const std::vector<uint8_t>& p) { return timed_get(*q, p); });
+    }
+    zenoh::Session client = zenoh::Session::open(zenoh::Config::create_default());
+    return measure_with(args, size, [&](const std::vector<uint8_t>& p) { return timed_get(client, p); });
+}
+
+std::vector<double> run_node(const bench::Args& args, size_t size, bool querier) {
+    Node server("bench_query_server");
+    server.create_view_server(kKey, [](const std::string&, const std::string&, BytesView in) {
+        return in.to_vector();
+    });
+    return measure(args, size, querier);
+}
+
+struct ZuServer {
+    ZU_NodeHandle node = 0;
+};
+
+void ZU_CALL zu_on_query(uint64_t request_id, const char*, const uint8_t* payload, int32_t len,
+                         const char*, void* user) {
+    ZU_CompleteRequest(static_cast<ZuServer*>(user)->node, request_id, payload, len);
+}
+
+std::vector<double> run_zu(const bench::Args& args, size_t size, bool querier) {
+    ZuServer ctx;
+    ctx.node = ZU_CreateNode("bench_query_zu_server");
+    ZU_CreateServer(ctx.node, kKey, zu_on_query, &ctx, 1000);
+    auto rtts = measure(args, size, querier);
+    ZU_DestroyNode(ctx.node);
+    return rtts;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Args args(argc, argv, {0, 64, 1024, 16384});
+    bench::Report report("bench_query");
+
+    for (const char* api : {"node", "zu"}) {
+        for (const char* client : {"session", "querier"}) {
+            for (size_t size : args.sizes) {
+                const bool zu = std::strcmp(api, "zu") == 0;
+                const bool querier = std::strcmp(client, "querier") == 0;
+                auto rtts = zu ? run_zu(args, size, querier) : run_node(args, size, querier);
+                report.row().add("api", api).add("client", client).add("bytes", static_cast<uint64_t>(size))
+                      .add("lost", static_cast<uint64_t>(args.iters - rtts.size()))
+                      .add_latency(bench::summarize(std::move(rtts)));
+            }
+        }
+    }
+    report.write(args.out);
+    return 0;
+}
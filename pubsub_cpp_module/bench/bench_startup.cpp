@@ -0,0 +1,109 @@
+// bench_startup.cpp
+// Cost of bringing up a subscriber/publisher node pair, per session preset: how long the
+// Node constructors take, how long until the first published sample is delivered, and
+// how long tearing the pair down takes. This is what a Unity scene reload pays.
+// Explicit-endpoint presets listen/connect on 127.0.0.1, one port per iteration. Every row
+// but "shared_session" opens two private sessions; that one lets the pair share a session.
+#include "bench_common.h"
+#include "node.h"
+#include <atomic>
+#include <memory>
+
+using ubicoders_zenoh::BytesView;
+using ubicoders_zenoh::Node;
+using ubicoders_zenoh::NodeOptions;
+using ubicoders_zenoh::SessionPreset;
+
+namespace {
+
+const char* kKey = "bench/startup/first";
+
+struct Setup {
+    NodeOptions sub;
+    NodeOptions pub;
+};
+
+Setup make_setup(const std::string& which, int port) {
+    const std::string ep = "tcp/127.0.0.1:" + std::to_string(port);
+    Setup s;
+    s.sub.share_session = s.pub.share_session = which == "shared_session";
+    if (which == "no_scouting") {
+        s.sub.preset = s.pub.preset = SessionPreset::NoScouting;
+        s.sub.listen = {ep};
+        s.pub.connect = {ep};
+    } else if (which == "fixed_connect") {
+        s.sub.preset = SessionPreset::NoScouting;
+        s.sub.listen = {ep};
+        s.pub.preset = SessionPreset::FixedConnect;
+        s.pub.connect = {ep};
+    }
+    return s;
+}
+
+struct Sample {
+    double open_ns = 0;   // both Node constructors
+    double first_ns = -1; // pair creation start to first delivered sample; < 0: none in time
+    double close_ns = 0;  // both shutdowns
+};
+
+Sample run_once(const Setup& setup) {
+    Sample out;
+    std::atomic<bool> got{false};
+    std::atomic<int64_t> got_at{0};
+
+    const auto t0 = bench::Clock::now();
+    auto sub = std::make_unique<Node>("bench_startup_sub", setup.sub);
+    auto pub = std::make_unique<Node>("bench_startup_pub", setup.pub);
+    out.open_ns = bench::elapsed_ns(t0, bench::Clock::now());
+
+    sub->create_view_subscriber(kKey, [&](const std::string&, BytesView) {
+        if (!got.exchange(true)) got_at.store(bench::Clock::now().time_since_epoch().count());
+    });
+    auto publisher = pub->declare_publisher(kKey);
+    const uint8_t byte = 1;
+    const auto give_up = t0 + std::chrono::seconds(10);
+    while (!got.load() && bench::Clock::now() < give_up) {
+        publisher->publish(&byte, 1);
+        bench::wait_for([&] { return got.load(); }, std::chrono::milliseconds(1));
+    }
+    if (got.load()) {
+        const bench::Clock::time_point t1{bench::Clock::duration(got_at.load())};
+        out.first_ns = bench::elapsed_ns(t0, t1);
+    }
+
+    const auto t2 = bench::Clock::now();
+    publisher.reset();
+    pub->shutdown();
+    sub->shutdown();
+    out.close_ns = bench::elapsed_ns(t2, bench::Clock::now());
+    return out;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Args args(argc, argv, {}, 20, 2);
+    bench::Report report("bench_startup");
+
+    int port = 17400;
+    for (const char* which : {"default", "no_scouting", "fixed_connect", "shared_session"}) {
+        std::vector<double> open, first, close;
+        for (int i = 0; i < args.warmup + args.iters; ++i) {
+            const Setup setup = make_setup(which, port++);
+            const Sample s = run_once(setup);
+            if (i < args.warmup) continue;
+            open.push_back(s.open_ns);
+            close.push_back(s.close_ns);
+            if (s.first_ns >= 0) first.push_back(s.first_ns);
+        }
+        const auto o = bench::summarize(open), f = bench::summarize(first), c = bench::summarize(close);
+        report.row().add("preset", which)
+              .add("lost", static_cast<uint64_t>(args.iters - first.size()))
+              .add("open_p50_ms", o.p50 / 1e6).add("open_max_ms", o.max / 1e6)
+              .add("first_p50_ms", f.p50 / 1e6).add("first_p90_ms", f.p90 / 1e6)
+              .add("first_max_ms", f.max / 1e6)
+              .add("close_p50_ms", c.p50 / 1e6);
+    }
+    report.write(args.out);
+    return 0;
+}
@@ -0,0 +1,129 @@
+// bench_throughput.cpp
+// Sustained one-way throughput over a sweep of payload sizes between two in-process nodes
+// (or one, with --same-node), through the C++ Node and through the ZU_* C ABI.
+// The publisher sends back to back for --seconds; the receiver counts messages and bytes.
+#include "bench_common.h"
+#include "node.h"
+#include "zenoh_unity_wrapper.h"
+#include <atomic>
+#include <cstring>
+#include <memory>
+
+using ubicoders_zenoh::BytesView;
+using ubicoders_zenoh::Node;
+
+namespace {
+
+const char* kKey = "bench/throughput";
+
+struct Counters {
+    std::atomic<uint64_t> msgs{0};
+    std::atomic<uint64_t> bytes{0};
+};
+
+struct Result {
+    uint64_t sent = 0;
+    uint64_t received = 0;
+    uint64_t received_bytes = 0;
+    double seconds = 0;
+};
+
+// Publishes through `send` for the configured duration, then lets in-flight samples drain.
+template <class Send>
+Result blast(const bench::Args& args, size_t size, Counters& rx, Send send) {
+    std::vector<uint8_t> payload(size, 0xA5);
+    Result r;
+
+    // Wait until the receiver sees us
+    if (!bench::wait_for([&] { send(payload); return rx.msgs.load() > 0; }, std::chrono::seconds(10))) {
+        std::fprintf(stderr, "nothing received; are the sessions connected?\n");
+        return r;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    const uint64_t m0 = rx.msgs.load(), b0 = rx.bytes.load();
+
+    const auto t0 = bench::Clock::now();
+    const auto end = t0 + std::chrono::duration<double>(args.seconds);
+    while (bench::Clock::now() < end) {
+        for (int i = 0; i < 64; ++i) send(payload);
+        r.sent += 64;
+    }
+    // Drain: stop once the counter holds still for 100 ms
+    uint64_t last = rx.msgs.load();
+    do {
+        last = rx.msgs.load();
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    } while (rx.msgs.load() != last);
+    const auto t1 = bench::Clock::now();
+
+    r.received = rx.msgs.load() - m0;
+    r.received_bytes = rx.bytes.load() - b0;
+    r.seconds = std::chrono::duration<double>(t1 - t0).count();
+    return r;
+}
+
+Result run_node(const bench::Args& args, size_t size) {
+    Counters rx;
+    ubicoders_zenoh::NodeOptions own;
+    own.share_session = false;  // two nodes means two sessions here
+    auto tx = std::make_unique<Node>("bench_throughput_tx", own);
+    std::unique_ptr<Node> rx_owned = args.same_node ? nullptr : std::make_unique<Node>("bench_throughput_rx", own);
+    Node& rx_node = args.same_node ? *tx : *rx_owned;
+
+    rx_node.create_view_subscriber(kKey, [&](const std::string&, BytesView v) {
+        rx.msgs.fetch_add(1, std::memory_order_relaxed);
+        rx.bytes.fetch_add(v.size, std::memory_order_relaxed);
+    });
+    auto pub = tx->declare_publisher(kKey);
+    Result r = blast(args, size, rx, [&](const std::vector<uint8_t>& p) { pub->publish(p.data(), p.size()); });
+    tx->shutdown();
+    if (rx_owned) rx_owned->shutdown();
+    return r;
+}
+
+void ZU_CALL zu_on_sample(const char*, const uint8_t*, int32_t len, void* user) {
+    auto* c = static_cast<Counters*>(user);
+    c->msgs.fetch_add(1, std::memory_order_relaxed);
+    c->bytes.fetch_add(static_cast<uint64_t>(len), std::memory_order_relaxed);
+}
+
+Result run_zu(const bench::Args& args, size_t size) {
+    Counters rx;
+    ZU_NodeOptions own = {};
+    own.private_session = 1;
+    ZU_NodeHandle tx = ZU_CreateNodeWithOptions("bench_throughput_zu_tx", &own);
+    ZU_NodeHandle rx_node = args.same_node ? tx : ZU_CreateNodeWithOptions("bench_throughput_zu_rx", &own);
+    ZU_CreateSubscriber(rx_node, kKey, zu_on_sample, &rx);
+    ZU_PublisherHandle pub = ZU_DeclarePublisher(tx, kKey);
+
+    Result r = blast(args, size, rx, [&](const std::vector<uint8_t>& p) {
+        ZU_PublishTo(pub, p.data(), static_cast<int32_t>(p.size()));
+    });
+
+    ZU_UndeclarePublisher(pub);
+    if (rx_node != tx) ZU_DestroyNode(rx_node);
+    ZU_DestroyNode(tx);
+    return r;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Args args(argc, argv, {8, 64, 512, 4096, 32768, 262144, 1048576});
+    bench::Report report("bench_throughput");
+
+    for (const char* api : {"node", "zu"}) {
+        for (size_t size : args.sizes) {
+            const bool zu = std::strcmp(api, "zu") == 0;
+            const Result r = zu ? run_zu(args, size) : run_node(args, size);
+            const double secs = r.seconds > 0 ? r.seconds : 1;
+            report.row().add("api", api).add("bytes", static_cast<uint64_t>(size))
+                  .add("sent", r.sent).add("received", r.received)
+                  .add("msgs_per_s", r.received / secs)
+                  .add("MB_per_s", r.received_bytes / secs / 1e6)
+                  .add("loss_pct", r.sent ? 100.0 * (1.0 - double(r.received) / r.sent) : 0.0);
+        }
+    }
+    report.write(args.out);
+    return 0;
+}
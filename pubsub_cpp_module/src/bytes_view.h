@@ -0,0 +1,21 @@
+// bytes_view.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ubicoders_zenoh {
+
+// Read-only view over a received payload. Only valid for the duration of the callback.
+struct BytesView {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+
+    const uint8_t* begin() const { return data; }
+    const uint8_t* end() const { return data + size; }
+    bool empty() const { return size == 0; }
+    std::vector<uint8_t> to_vector() const { return std::vector<uint8_t>(begin(), end()); }
+};
+
+} // namespace ubicoders_zenoh
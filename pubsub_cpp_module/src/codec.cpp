@@ -0,0 +1,105 @@
+// codec.cpp
+#include "codec.h"
+
+#include <climits>
+
+// Set by CMake when the library was found
+#ifndef ZNODE_HAS_LZ4
+#define ZNODE_HAS_LZ4 0
+#endif
+#ifndef ZNODE_HAS_ZSTD
+#define ZNODE_HAS_ZSTD 0
+#endif
+
+#if ZNODE_HAS_LZ4
+#include <lz4.h>
+#endif
+#if ZNODE_HAS_ZSTD
+#include <zstd.h>
+#endif
+
+namespace ubicoders_zenoh {
+
+namespace {
+#if ZNODE_HAS_ZSTD
+// zstd contexts are costly to create; keep one of each per thread
+struct ZstdContexts {
+    ZSTD_CCtx* c = ZSTD_createCCtx();
+    ZSTD_DCtx* d = ZSTD_createDCtx();
+    ~ZstdContexts() {
+        ZSTD_freeCCtx(c);
+        ZSTD_freeDCtx(d);
+    }
+};
+thread_local ZstdContexts t_zstd;
+#endif
+} // namespace
+
+bool compression_available(Compression codec) {
+    switch (codec) {
+    case Compression::None: return true;
+    case Compression::LZ4: return ZNODE_HAS_LZ4 != 0;
+    case Compression::Zstd: return ZNODE_HAS_ZSTD != 0;
+    }
+    return false;
+}
+
+size_t compress_bound(Compression codec, size_t len) {
+    switch (codec) {
+#if ZNODE_HAS_LZ4
+    case Compression::LZ4:
+        return len <= LZ4_MAX_INPUT_SIZE ? static_cast<size_t>(LZ4_compressBound(static_cast<int>(len))) : 0;
+#endif
+#if ZNODE_HAS_ZSTD
+    case Compression::Zstd: return ZSTD_compressBound(len);
+#endif
+    default:
+        (void)len;
+        return 0;
+    }
+}
+
+size_t compress(Compression codec, int level, const uint8_t* in, size_t len, uint8_t* out, size_t cap) {
+    switch (codec) {
+#if ZNODE_HAS_LZ4
+    case Compression::LZ4: {
+        if (len > LZ4_MAX_INPUT_SIZE || cap > INT_MAX) return 0;
+        const int n = LZ4_compress_fast(reinterpret_cast<const char*>(in), reinterpret_cast<char*>(out),
+                                        static_cast<int>(len), static_cast<int>(cap), level > 0 ? level : 1);
+        return n > 0 ? static_cast<size_t>(n) : 0;
+    }
+#endif
+#if ZNODE_HAS_ZSTD
+    case Compression::Zstd: {
+        const size_t n = ZSTD_compressCCtx(t_zstd.c, out, cap, in, len, level > 0 ? level : 3);
+        return ZSTD_isError(n) ? 0 : n;
+    }
+#endif
+    default:
+        (void)level; (void)in; (void)len; (void)out; (void)cap;
+        return 0;
+    }
+}
+
+bool decompress(Compression codec, const uint8_t* in, size_t len, uint8_t* out, size_t raw_len) {
+    switch (codec) {
+    case Compression::None: return false;
+#if ZNODE_HAS_LZ4
+    case Compression::LZ4:
+        if (len > INT_MAX || raw_len > INT_MAX) return false;
+        return LZ4_decompress_safe(reinterpret_cast<const char*>(in), reinterpret_cast<char*>(out),
+                                   static_cast<int>(len), static_cast<int>(raw_len)) == static_cast<int>(raw_len);
+#endif
+#if ZNODE_HAS_ZSTD
+    case Compression::Zstd: {
+        const size_t n = ZSTD_decompressDCtx(t_zstd.d, out, raw_len, in, len);
+        return !ZSTD_isError(n) && n == raw_len;
+    }
+#endif
+    default:
+        (void)in; (void)len; (void)out; (void)raw_len;
+        return false;
+    }
+}
+
+} // namespace ubicoders_zenoh
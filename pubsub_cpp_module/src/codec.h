@@ -0,0 +1,36 @@
+// codec.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ubicoders_zenoh {
+
+// Payload compression codecs. Each is compiled in only when its library was found at build
+// time (ZNODE_HAS_LZ4 / ZNODE_HAS_ZSTD); see compression_available().
+enum class Compression : uint8_t {
+    None = 0,
+    LZ4 = 1,   // fast, modest ratio
+    Zstd = 2,  // better ratio for more CPU; the choice when bandwidth is the bottleneck
+};
+
+struct CompressionOptions {
+    Compression codec = Compression::None;  // a codec that is not compiled in acts as None
+    size_t threshold = 512;  // smaller payloads are always sent raw
+    int level = 0;           // 0: codec default. zstd: 1..19; lz4: acceleration (higher is faster)
+    // A payload goes out compressed only if that saves at least this fraction of it. After
+    // a run of payloads that do not, the publisher only tries every few payloads until one does.
+    double min_saving = 0.1;
+};
+
+bool compression_available(Compression codec);
+
+// Largest compressed size of `len` input bytes (0: codec unavailable)
+size_t compress_bound(Compression codec, size_t len);
+// Compresses into `out` (`cap` bytes, at least compress_bound). Returns the compressed
+// size, or 0 on failure.
+size_t compress(Compression codec, int level, const uint8_t* in, size_t len, uint8_t* out, size_t cap);
+// Decompresses exactly `raw_len` bytes into `out`. False on corrupt input or unavailable codec.
+bool decompress(Compression codec, const uint8_t* in, size_t len, uint8_t* out, size_t raw_len);
+
+} // namespace ubicoders_zenoh
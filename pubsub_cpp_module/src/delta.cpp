@@ -0,0 +1,140 @@
+// delta.cpp
+#include "delta.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ubicoders_zenoh {
+
+namespace {
+// Unchanged bytes that end a run; shorter gaps are cheaper to carry as zero XOR bytes than
+// to encode as a new run
+constexpr size_t kRunGap = 4;
+
+size_t varint_size(uint64_t v) {
+    size_t n = 1;
+    while (v >= 0x80) { v >>= 7; ++n; }
+    return n;
+}
+
+uint8_t* put_varint(uint8_t* p, uint64_t v) {
+    while (v >= 0x80) {
+        *p++ = static_cast<uint8_t>(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = static_cast<uint8_t>(v);
+    return p;
+}
+
+bool get_varint(const uint8_t*& p, const uint8_t* end, uint64_t& v) {
+    v = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7) {
+        const uint8_t b = *p++;
+        v |= static_cast<uint64_t>(b & 0x7f) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+bool same8(const uint8_t* a, const uint8_t* b) {
+    uint64_t x, y;
+    std::memcpy(&x, a, 8);
+    std::memcpy(&y, b, 8);
+    return x == y;
+}
+} // namespace
+
+// ---- Encoding ----
+
+bool delta_encode(const uint8_t* prev, const uint8_t* cur, size_t len, uint8_t* out, size_t cap,
+                  size_t& out_len) {
+    size_t n = 0, i = 0, last_end = 0;
+    while (i < len) {
+        while (i + 8 <= len && same8(prev + i, cur + i)) i += 8;
+        while (i < len && prev[i] == cur[i]) ++i;
+        if (i == len) break;
+
+        const size_t start = i;
+        size_t end = i + 1, same = 0;
+        for (i = end; i < len && same < kRunGap; ++i) {
+            if (prev[i] == cur[i]) {
+                ++same;
+            } else {
+                same = 0;
+                end = i + 1;
+            }
+        }
+        const size_t count = end - start;
+        if (n + varint_size(start - last_end) + varint_size(count) + count > cap) return false;
+        uint8_t* p = put_varint(put_varint(out + n, start - last_end), count);
+        for (size_t k = start; k < end; ++k) *p++ = prev[k] ^ cur[k];
+        n = static_cast<size_t>(p - out);
+        i = last_end = end;
+    }
+    out_len = n;
+    return true;
+}
+
+bool delta_apply(uint8_t* base, size_t len, const uint8_t* delta, size_t delta_len) {
+    const uint8_t* p = delta;
+    const uint8_t* end = delta + delta_len;
+    size_t pos = 0;
+    while (p < end) {
+        uint64_t skip, count;
+        if (!get_varint(p, end, skip) || !get_varint(p, end, count)) return false;
+        if (skip > len - pos || count > len - pos - skip || count > static_cast<size_t>(end - p)) return false;
+        pos += skip;
+        for (uint64_t k = 0; k < count; ++k) base[pos++] ^= *p++;
+    }
+    return true;
+}
+
+// ---- DeltaDecoder ----
+
+std::shared_ptr<DeltaDecoder::Stream> DeltaDecoder::stream(uint64_t source) {
+    std::lock_guard<std::mutex> lk(_mx);
+    auto it = _streams.find(source);
+    if (it != _streams.end()) {
+        _recency.splice(_recency.begin(), _recency, it->second);
+        return *it->second;
+    }
+    if (_streams.size() >= _max_streams) {
+        // Full: forget the publisher heard from least recently
+        _streams.erase(_recency.back()->source);
+        _recency.pop_back();
+    }
+    auto s = std::make_shared<Stream>();
+    s->source = source;
+    _recency.push_front(s);
+    _streams.emplace(source, _recency.begin());
+    return s;
+}
+
+DeltaDecoder::Outcome DeltaDecoder::update_locked(Stream& s, const DeltaHeader& h, BytesView payload) {
+    // Wrap-safe distance from the sample the stream holds
+    const int32_t ahead = static_cast<int32_t>(h.seq - s.seq);
+    if (h.keyframe) {
+        if (payload.size != h.size) return Outcome::Stale;  // malformed: wait for the next one
+        if (s.valid && ahead <= 0) return Outcome::Stale;
+        s.base.assign(payload.begin(), payload.end());
+        s.seq = h.seq;
+        s.valid = true;
+        return Outcome::Delivered;
+    }
+    if (s.valid && ahead <= 0) return Outcome::Stale;
+    if (s.valid && ahead == 1 && s.base.size() == h.size &&
+        delta_apply(s.base.data(), s.base.size(), payload.data, payload.size)) {
+        s.seq = h.seq;
+        return Outcome::Delivered;
+    }
+    // Lost a sample, joined mid-stream or got a bad delta: nothing decodes until a keyframe
+    s.valid = false;
+    s.seq = h.seq;
+    const auto now = std::chrono::steady_clock::now();
+    if (s.requested != std::chrono::steady_clock::time_point() && now - s.requested < kRequestRetry)
+        return Outcome::Missing;
+    s.requested = now;
+    return Outcome::RequestKeyframe;
+}
+
+} // namespace ubicoders_zenoh
@@ -0,0 +1,89 @@
+// delta.h
+#pragma once
+
+#include "bytes_view.h"
+#include "sample_header.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace ubicoders_zenoh {
+
+// Delta publishing of state streams whose consecutive samples differ in a few bytes
+struct DeltaOptions {
+    // > 0: payloads go out as deltas against the previous one, with a full keyframe every
+    // `keyframe_interval` samples. 0: off.
+    uint32_t keyframe_interval = 0;
+    // A delta larger than this fraction of the payload goes out as a keyframe instead, as
+    // does any payload whose size differs from the previous one
+    double max_delta_ratio = 0.5;
+};
+
+// A delta is a list of runs: varint skip (unchanged bytes since the previous run), varint
+// count, then `count` bytes holding the XOR of the old and new bytes.
+
+// Encodes `cur` against `prev` (both `len` bytes) into `out`. False if it needs more than
+// `cap` bytes.
+bool delta_encode(const uint8_t* prev, const uint8_t* cur, size_t len, uint8_t* out, size_t cap,
+                  size_t& out_len);
+// Applies a delta to `base` in place. False if it is malformed, which may leave `base`
+// partly updated.
+bool delta_apply(uint8_t* base, size_t len, const uint8_t* delta, size_t delta_len);
+
+// Rebuilds full payloads from the keyframes and deltas of one subscription, per publisher
+// (DeltaHeader::source). zenoh keeps a publisher's samples in order, so a sequence gap
+// means a lost sample.
+class DeltaDecoder {
+public:
+    enum class Outcome {
+        Delivered,
+        Stale,            // a keyframe the stream already has (or an older one): ignored
+        Missing,          // a delta without its base; a keyframe was requested recently
+        RequestKeyframe,  // same, and it is time to ask the publisher for a keyframe
+    };
+
+    static constexpr std::chrono::milliseconds kRequestRetry{100};
+
+    // Past `max_streams` publishers, the one heard from least recently is forgotten
+    explicit DeltaDecoder(size_t max_streams = 16) : _max_streams(max_streams ? max_streams : 1) {}
+    DeltaDecoder(const DeltaDecoder&) = delete;
+    DeltaDecoder& operator=(const DeltaDecoder&) = delete;
+
+    // Updates the publisher's stream and, once it holds the full payload, calls
+    // `deliver(BytesView)` with it. `deliver` runs under that stream's lock.
+    template <class F>
+    Outcome apply(const DeltaHeader& h, BytesView payload, F&& deliver) {
+        auto s = stream(h.source);
+        std::lock_guard<std::mutex> lk(s->mx);
+        const Outcome r = update_locked(*s, h, payload);
+        if (r == Outcome::Delivered) deliver(BytesView{s->base.data(), s->base.size()});
+        return r;
+    }
+
+private:
+    struct Stream {
+        uint64_t source = 0;
+        std::mutex mx;
+        std::vector<uint8_t> base;  // the last full payload, reused
+        uint32_t seq = 0;
+        bool valid = false;
+        std::chrono::steady_clock::time_point requested;
+    };
+    using Recency = std::list<std::shared_ptr<Stream>>;  // most recently heard from first
+
+    std::shared_ptr<Stream> stream(uint64_t source);
+    Outcome update_locked(Stream& s, const DeltaHeader& h, BytesView payload);
+
+    const size_t _max_streams;
+    std::mutex _mx;
+    Recency _recency;
+    std::unordered_map<uint64_t, Recency::iterator> _streams;
+};
+
+} // namespace ubicoders_zenoh
@@ -0,0 +1,214 @@
+// dispatcher.cpp
+#include "dispatcher.h"
+
+namespace ubicoders_zenoh {
+
+namespace {
+// Set on dispatcher worker threads: which pool core they belong to and their slot in it
+thread_local const void* t_pool = nullptr;
+thread_local size_t t_slot = 0;
+
+DispatchOptions sanitized(DispatchOptions o) {
+    if (o.capacity == 0) o.capacity = 1;
+    return o;
+}
+
+const InternedKey* intern_or(const InternedKey& own) {
+    const InternedKey* k = KeyTable::global().intern(own.name);
+    return k ? k : &own;
+}
+} // namespace
+
+// ---- DispatchQueue ----
+
+DispatchQueue::DispatchQueue(std::string key, Handler handler, DispatchOptions opts,
+                             std::weak_ptr<Dispatcher> owner)
+    : _own_key{0, std::move(key)}, _key(intern_or(_own_key)), _handler(std::move(handler)), _opts(sanitized(opts)), _owner(std::move(owner)) {}
+
+// Keeps at most `capacity` spare buffers, so a steady stream stops allocating
+void DispatchQueue::recycle_locked(std::vector<uint8_t>&& buf) {
+    if (!_closed && buf.capacity() && _free.size() < _opts.capacity) _free.push_back(std::move(buf));
+}
+
+size_t DispatchQueue::pending() const {
+    std::lock_guard<std::mutex> lk(_mx);
+    return _items.size();
+}
+
+bool DispatchQueue::push(const InternedKey& sample_key, BytesView payload) {
+    std::unique_lock<std::mutex> lk(_mx);
+    if (_closed) return false;
+
+    bool dropped = false;
+    if (_items.size() >= _opts.capacity) {
+        auto pool = _owner.lock();
+        // Blocking from a worker could wait on the very queue it is running; drop instead
+        const bool can_block = _opts.overflow == OverflowPolicy::Block && pool && !pool->on_worker_thread();
+        if (can_block) {
+            _not_full.wait(lk, [&] { return _closed || _items.size() < _opts.capacity; });
+            if (_closed) return false;
+        } else if (_opts.overflow == OverflowPolicy::DropOldest) {
+            recycle_locked(std::move(_items.front().payload));
+            _items.pop_front();
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            dropped = true;
+        } else {  // DropNewest, or Block on a worker thread
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+
+    std::vector<uint8_t> buf;
+    if (!_free.empty()) {
+        buf = std::move(_free.back());
+        _free.pop_back();
+    }
+    buf.assign(payload.begin(), payload.end());
+    _items.emplace_back();
+    Item& item = _items.back();
+    item.payload = std::move(buf);
+    if (sample_key.id == 0) item.uninterned = sample_key;
+    else if (sample_key.id != _key->id) item.key = &sample_key;
+
+    const bool wake = !_scheduled;
+    _scheduled = true;
+    lk.unlock();
+
+    if (wake) {
+        if (auto pool = _owner.lock()) pool->schedule(shared_from_this());
+    }
+    return !dropped;
+}
+
+void DispatchQueue::close() {
+    {
+        std::lock_guard<std::mutex> lk(_mx);
+        _closed = true;
+        _items.clear();
+        _free.clear();
+    }
+    _not_full.notify_all();
+}
+
+bool DispatchQueue::run_batch(size_t max_items) {
+    Item cur;
+    for (size_t i = 0; i < max_items; ++i) {
+        {
+            std::lock_guard<std::mutex> lk(_mx);
+            if (i > 0) recycle_locked(std::move(cur.payload));
+            if (_items.empty()) {
+                _scheduled = false;
+                return false;
+            }
+            cur = std::move(_items.front());
+            _items.pop_front();
+        }
+        _not_full.notify_one();
+
+        try {
+            const InternedKey& k = cur.key ? *cur.key : cur.uninterned.name.empty() ? *_key : cur.uninterned;
+            _handler(k, BytesView{cur.payload.data(), cur.payload.size()});
+        } catch (...) {
+            _errors.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    std::lock_guard<std::mutex> lk(_mx);
+    recycle_locked(std::move(cur.payload));
+    if (_items.empty()) {
+        _scheduled = false;
+        return false;
+    }
+    return true;
+}
+
+// ---- Dispatcher ----
+
+Dispatcher::Dispatcher(size_t threads) : _core(std::make_shared<Core>()) {
+    if (threads == 0) threads = 1;
+    for (size_t i = 0; i < threads; ++i) _core->workers.push_back(std::make_unique<Worker>());
+    for (size_t i = 0; i < threads; ++i) _threads.emplace_back([core = _core, i] { core->worker_loop(i); });
+}
+
+Dispatcher::~Dispatcher() { stop(); }
+
+std::shared_ptr<DispatchQueue> Dispatcher::make_queue(const std::string& key, DispatchQueue::Handler handler,
+                                                      const DispatchOptions& opts) {
+    return std::shared_ptr<DispatchQueue>(
+        new DispatchQueue(key, std::move(handler), opts, weak_from_this()));
+}
+
+void Dispatcher::stop() {
+    {
+        std::lock_guard<std::mutex> lk(_core->idle_mx);
+        if (_core->stop.exchange(true)) return;
+    }
+    _core->idle_cv.notify_all();
+    for (auto& t : _threads) {
+        if (!t.joinable()) continue;
+        // Stopped from its own callback: the worker exits on its own and keeps the core alive
+        if (t.get_id() == std::this_thread::get_id()) t.detach();
+        else t.join();
+    }
+    for (auto& w : _core->workers) {
+        std::lock_guard<std::mutex> lk(w->mx);
+        w->ready.clear();
+    }
+}
+
+bool Dispatcher::on_worker_thread() const {
+    return t_pool == _core.get();
+}
+
+void Dispatcher::Core::schedule(std::shared_ptr<DispatchQueue> q) {
+    if (stop.load(std::memory_order_acquire)) return;
+    // Workers keep their own follow-up work local; producers spread round-robin
+    const size_t target = t_pool == this
+        ? t_slot
+        : next.fetch_add(1, std::memory_order_relaxed) % workers.size();
+    {
+        std::lock_guard<std::mutex> lk(workers[target]->mx);
+        workers[target]->ready.push_back(std::move(q));
+    }
+    ready.fetch_add(1, std::memory_order_release);
+    { std::lock_guard<std::mutex> lk(idle_mx); }  // pairs with the predicate check in worker_loop
+    idle_cv.notify_one();
+}
+
+// Own deque from the front, others' from the back
+bool Dispatcher::Core::take(size_t self, std::shared_ptr<DispatchQueue>& out) {
+    const size_t n = workers.size();
+    for (size_t k = 0; k < n; ++k) {
+        Worker& w = *workers[(self + k) % n];
+        std::lock_guard<std::mutex> lk(w.mx);
+        if (w.ready.empty()) continue;
+        if (k == 0) {
+            out = std::move(w.ready.front());
+            w.ready.pop_front();
+        } else {
+            out = std::move(w.ready.back());
+            w.ready.pop_back();
+        }
+        ready.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void Dispatcher::Core::worker_loop(size_t self) {
+    t_pool = this;
+    t_slot = self;
+    while (!stop.load(std::memory_order_acquire)) {
+        std::shared_ptr<DispatchQueue> q;
+        if (take(self, q)) {
+            if (q->run_batch(kBatch)) schedule(std::move(q));  // let other keys have a turn
+            continue;
+        }
+        std::unique_lock<std::mutex> lk(idle_mx);
+        idle_cv.wait(lk, [&] {
+            return stop.load(std::memory_order_acquire) || ready.load(std::memory_order_acquire) > 0;
+        });
+    }
+}
+
+} // namespace ubicoders_zenoh
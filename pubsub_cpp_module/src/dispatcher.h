@@ -0,0 +1,132 @@
+// dispatcher.h
+#pragma once
+
+#include "bytes_view.h"
+#include "key_table.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ubicoders_zenoh {
+
+// What a full dispatch queue does with the next sample
+enum class OverflowPolicy {
+    DropOldest = 0,  // evict the oldest queued sample (default: consumers see fresh data)
+    DropNewest = 1,  // discard the incoming sample
+    Block      = 2,  // stall the delivering zenoh thread until the consumer catches up
+};
+
+struct DispatchOptions {
+    size_t capacity = 1024;  // samples queued per subscription
+    OverflowPolicy overflow = OverflowPolicy::DropOldest;
+};
+
+class Dispatcher;
+
+// Bounded FIFO of one subscription, drained by the dispatcher's workers. At most one
+// worker runs a queue at a time, so a key's callbacks keep arrival order; different
+// keys run in parallel. Samples are copied in on the zenoh thread into recycled buffers.
+class DispatchQueue : public std::enable_shared_from_this<DispatchQueue> {
+public:
+    using Handler = std::function<void(const InternedKey& key, BytesView payload)>;
+
+    DispatchQueue(const DispatchQueue&) = delete;
+    DispatchQueue& operator=(const DispatchQueue&) = delete;
+
+    const std::string& key() const { return _key->name; }
+    const DispatchOptions& options() const { return _opts; }
+    uint64_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+    uint64_t errors() const { return _errors.load(std::memory_order_relaxed); }  // throwing callbacks
+    size_t pending() const;
+
+    // Producer side (zenoh RX threads). `sample_key` is the concrete key of a wildcard
+    // subscription's sample; interned keys are queued by pointer. Returns false if a sample
+    // was dropped.
+    bool push(const InternedKey& sample_key, BytesView payload);
+    // Discards queued samples and wakes blocked producers; later pushes are dropped.
+    void close();
+
+private:
+    friend class Dispatcher;
+    DispatchQueue(std::string key, Handler handler, DispatchOptions opts, std::weak_ptr<Dispatcher> owner);
+    struct Item {
+        std::vector<uint8_t> payload;
+        const InternedKey* key = nullptr;  // null: the subscription key itself
+        InternedKey uninterned;            // copy of a key the full KeyTable could not take
+    };
+
+    bool run_batch(size_t max_items);  // true: samples remain, reschedule
+    void recycle_locked(std::vector<uint8_t>&& buf);
+
+    const InternedKey _own_key;  // used only when the full KeyTable could not take the key
+    const InternedKey* const _key;  // interned (lives for the process), else &_own_key
+    const Handler _handler;
+    const DispatchOptions _opts;
+    const std::weak_ptr<Dispatcher> _owner;
+
+    mutable std::mutex _mx;
+    std::condition_variable _not_full;
+    std::deque<Item> _items;
+    std::vector<std::vector<uint8_t>> _free;  // recycled sample buffers
+    bool _scheduled = false;  // queued on a worker or being run
+    bool _closed = false;
+    std::atomic<uint64_t> _dropped{0};
+    std::atomic<uint64_t> _errors{0};
+};
+
+// Fixed pool of workers running DispatchQueues. Each worker has its own deque of ready
+// queues and steals from the others when it runs dry, so one slow callback only occupies
+// one worker and never holds up other keys.
+class Dispatcher : public std::enable_shared_from_this<Dispatcher> {
+public:
+    explicit Dispatcher(size_t threads);
+    ~Dispatcher();
+    Dispatcher(const Dispatcher&) = delete;
+    Dispatcher& operator=(const Dispatcher&) = delete;
+
+    std::shared_ptr<DispatchQueue> make_queue(const std::string& key, DispatchQueue::Handler handler,
+                                              const DispatchOptions& opts);
+    size_t threads() const { return _threads.size(); }
+    // Joins the workers; queued samples are discarded. Safe to call from a worker: that
+    // worker is detached and finishes its batch on the shared core, never on `this`.
+    void stop();
+
+    static constexpr size_t kBatch = 32;  // samples per queue before yielding the worker
+
+private:
+    friend class DispatchQueue;
+    struct Worker {
+        std::mutex mx;
+        std::deque<std::shared_ptr<DispatchQueue>> ready;
+    };
+    // State the worker threads touch; each of them holds a reference
+    struct Core {
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::atomic<size_t> next{0};   // round-robin target for external producers
+        std::atomic<size_t> ready{0};  // queues sitting in worker deques
+        std::mutex idle_mx;
+        std::condition_variable idle_cv;
+        std::atomic<bool> stop{false};
+
+        void schedule(std::shared_ptr<DispatchQueue> q);
+        bool take(size_t self, std::shared_ptr<DispatchQueue>& out);
+        void worker_loop(size_t self);
+    };
+
+    void schedule(std::shared_ptr<DispatchQueue> q) { _core->schedule(std::move(q)); }
+    bool on_worker_thread() const;
+
+    const std::shared_ptr<Core> _core;
+    std::vector<std::thread> _threads;
+};
+
+} // namespace ubicoders_zenoh
@@ -0,0 +1,146 @@
+// fragment.cpp
+#include "fragment.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ubicoders_zenoh {
+
+// ---- BlobPool ----
+
+BlobPool::BlobPool(size_t max_buffers, size_t prealloc_bytes) : _max_buffers(max_buffers) {
+    if (prealloc_bytes == 0) return;
+    for (size_t i = 0; i < max_buffers; ++i)
+        _free.push_back(Buffer{std::unique_ptr<uint8_t[]>(new uint8_t[prealloc_bytes]), prealloc_bytes});
+}
+
+BlobPool::Buffer BlobPool::acquire(size_t len) {
+    {
+        std::lock_guard<std::mutex> lk(_mx);
+        auto best = _free.end();
+        for (auto it = _free.begin(); it != _free.end(); ++it) {
+            if (it->capacity >= len && (best == _free.end() || it->capacity < best->capacity)) best = it;
+        }
+        if (best != _free.end()) {
+            Buffer out = std::move(*best);
+            _free.erase(best);
+            return out;
+        }
+    }
+    return Buffer{std::unique_ptr<uint8_t[]>(new uint8_t[len]), len};  // uninitialized
+}
+
+void BlobPool::release(Buffer&& buf) {
+    if (!buf.data) return;
+    std::lock_guard<std::mutex> lk(_mx);
+    if (_free.size() < _max_buffers) {
+        _free.push_back(std::move(buf));
+        return;
+    }
+    // Full: keep the larger buffers, they serve more payloads
+    auto smallest = std::min_element(_free.begin(), _free.end(),
+        [](const Buffer& a, const Buffer& b) { return a.capacity < b.capacity; });
+    if (smallest != _free.end() && smallest->capacity < buf.capacity) *smallest = std::move(buf);
+}
+
+// ---- Reassembler ----
+
+Reassembler::Reassembler(const ReassemblyOptions& opts, std::shared_ptr<BlobPool> pool)
+    : _opts(opts), _pool(std::move(pool)) {}
+
+void Reassembler::retire_locked(TransferId id) {
+    if (_retired.size() >= kRetired) _retired.erase(_retired.begin());
+    _retired.push_back(id);
+}
+
+void Reassembler::drop_locked(size_t i) {
+    retire_locked(TransferId{_transfers[i].source, _transfers[i].transfer});
+    _pool->release(std::move(_transfers[i].buf));
+    _transfers.erase(_transfers.begin() + static_cast<std::ptrdiff_t>(i));
+}
+
+size_t Reassembler::expire_locked(std::chrono::steady_clock::time_point now) {
+    size_t dropped = 0;
+    for (size_t i = 0; i < _transfers.size();) {
+        if (now - _transfers[i].started > _opts.timeout) {
+            drop_locked(i);
+            ++dropped;
+        } else {
+            ++i;
+        }
+    }
+    return dropped;
+}
+
+size_t Reassembler::sweep() {
+    std::lock_guard<std::mutex> lk(_mx);
+    return expire_locked(std::chrono::steady_clock::now());
+}
+
+size_t Reassembler::add_locked(const FragmentHeader& h, BytesView fragment, BlobPool::Buffer& complete) {
+    std::lock_guard<std::mutex> lk(_mx);
+    const TransferId id{h.source, h.transfer};
+    if (std::find(_retired.begin(), _retired.end(), id) != _retired.end()) return 0;  // completed, or counted when dropped
+    if (h.total > _opts.max_payload_bytes || h.offset >= h.total || fragment.size > h.total - h.offset) {
+        retire_locked(id);  // malformed or oversized: nothing to keep
+        return 1;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    size_t dropped = expire_locked(now);
+
+    size_t i = 0;
+    while (i < _transfers.size() && !(_transfers[i].source == h.source && _transfers[i].transfer == h.transfer)) ++i;
+    if (i == _transfers.size()) {
+        if (_transfers.size() >= std::max<size_t>(_opts.max_transfers, 1)) {
+            drop_locked(0);  // oldest first
+            ++dropped;
+            --i;
+        }
+        _transfers.push_back(Transfer{h.source, h.transfer, h.total, 0, now, _pool->acquire(h.total), {}});
+    }
+    Transfer& t = _transfers[i];
+    if (t.total != h.total) {  // inconsistent fragment: give up on the transfer
+        drop_locked(i);
+        return dropped + 1;
+    }
+    if (fragment.size == 0) return dropped;
+
+    // Place [begin, end) among the covered ranges: a resent fragment lies inside one and is
+    // skipped; one straddling a range edge does not match the publisher's split
+    const uint32_t begin = h.offset;
+    const uint32_t end = h.offset + static_cast<uint32_t>(fragment.size);
+    auto next = std::upper_bound(t.covered.begin(), t.covered.end(), begin,
+        [](uint32_t off, const std::pair<uint32_t, uint32_t>& r) { return off < r.first; });
+    if (next != t.covered.begin() && std::prev(next)->second > begin) {
+        if (std::prev(next)->second >= end) return dropped;  // duplicate
+        drop_locked(i);
+        return dropped + 1;
+    }
+    if (next != t.covered.end() && next->first < end) {
+        drop_locked(i);
+        return dropped + 1;
+    }
+    std::memcpy(t.buf.data.get() + begin, fragment.data, fragment.size);
+    t.received += fragment.size;
+    const bool joins_prev = next != t.covered.begin() && std::prev(next)->second == begin;
+    const bool joins_next = next != t.covered.end() && next->first == end;
+    if (joins_prev && joins_next) {
+        std::prev(next)->second = next->second;
+        t.covered.erase(next);
+    } else if (joins_prev) {
+        std::prev(next)->second = end;
+    } else if (joins_next) {
+        next->first = begin;
+    } else {
+        t.covered.insert(next, {begin, end});
+    }
+
+    if (t.received >= t.total) {
+        complete = std::move(t.buf);
+        retire_locked(id);
+        _transfers.erase(_transfers.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+    return dropped;
+}
+
+} // namespace ubicoders_zenoh
@@ -0,0 +1,110 @@
+// fragment.h
+#pragma once
+
+#include "bytes_view.h"
+#include "sample_header.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace ubicoders_zenoh {
+
+// Subscriber-side limits on chunked payloads (see PublisherOptions::fragment_bytes)
+struct ReassemblyOptions {
+    size_t max_payload_bytes = size_t(256) << 20;  // larger transfers are dropped
+    size_t max_transfers = 4;  // incomplete per subscription; past that the oldest is dropped
+    std::chrono::milliseconds timeout{2000};  // incomplete transfers older than this are dropped
+    // Reassembly buffers the node keeps for reuse, each allocated with `prealloc_bytes` up
+    // front (0: allocated on first use and kept at their largest size)
+    size_t pool_buffers = 4;
+    size_t prealloc_bytes = 0;
+};
+
+// Recycled, uninitialized reassembly buffers shared by a node's subscriptions
+class BlobPool {
+public:
+    struct Buffer {
+        std::unique_ptr<uint8_t[]> data;
+        size_t capacity = 0;
+    };
+
+    BlobPool(size_t max_buffers, size_t prealloc_bytes);
+    BlobPool(const BlobPool&) = delete;
+    BlobPool& operator=(const BlobPool&) = delete;
+
+    // Smallest pooled buffer of at least `len` bytes, else a new one
+    Buffer acquire(size_t len);
+    void release(Buffer&& buf);  // freed when the pool is full
+
+private:
+    const size_t _max_buffers;
+    std::mutex _mx;
+    std::vector<Buffer> _free;
+};
+
+// Reassembles the fragments of one subscription. Fragments of a transfer may interleave
+// with other transfers and other sources; zenoh keeps a publisher's samples in order.
+class Reassembler {
+public:
+    Reassembler(const ReassemblyOptions& opts, std::shared_ptr<BlobPool> pool);
+    Reassembler(const Reassembler&) = delete;
+    Reassembler& operator=(const Reassembler&) = delete;
+
+    // Copies one fragment in. Once it completes a payload, calls `done(BytesView)` outside
+    // the lock; the view is valid for that call only. Returns the transfers dropped
+    // (oversized, malformed, timed out or evicted) while handling this fragment; each is
+    // counted once, and the rest of its fragments are ignored. Duplicate fragments are ignored.
+    template <class F>
+    size_t add(const FragmentHeader& h, BytesView fragment, F&& done) {
+        BlobPool::Buffer complete;
+        const size_t dropped = add_locked(h, fragment, complete);
+        if (complete.data) {
+            struct Recycle {
+                BlobPool& pool;
+                BlobPool::Buffer& buf;
+                ~Recycle() { pool.release(std::move(buf)); }
+            } recycle{*_pool, complete};
+            done(BytesView{complete.data.get(), h.total});
+        }
+        return dropped;
+    }
+
+    // Drops transfers past the timeout and returns how many. add() does this on every
+    // fragment; the node also calls it on a timer, so a publisher that stops mid-transfer
+    // does not keep a pooled buffer.
+    size_t sweep();
+
+private:
+    struct Transfer {
+        uint64_t source;
+        uint32_t transfer;
+        uint32_t total;
+        size_t received;
+        std::chrono::steady_clock::time_point started;
+        BlobPool::Buffer buf;
+        // Byte ranges copied in, sorted and merged: one range while fragments arrive in order
+        std::vector<std::pair<uint32_t, uint32_t>> covered;
+    };
+    using TransferId = std::pair<uint64_t, uint32_t>;  // source, transfer
+
+    size_t add_locked(const FragmentHeader& h, BytesView fragment, BlobPool::Buffer& complete);
+    void drop_locked(size_t i);
+    size_t expire_locked(std::chrono::steady_clock::time_point now);
+    void retire_locked(TransferId id);
+
+    static constexpr size_t kRetired = 16;  // finished transfers remembered
+
+    const ReassemblyOptions _opts;
+    const std::shared_ptr<BlobPool> _pool;
+    std::mutex _mx;
+    std::vector<Transfer> _transfers;  // a handful at most: scanned linearly
+    std::vector<TransferId> _retired;  // completed or dropped, most recent last: late fragments are ignored
+};
+
+} // namespace ubicoders_zenoh
@@ -0,0 +1,134 @@
+// handle_table.h
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ubicoders_zenoh {
+
+// Fixed-size slot array handing out 64-bit handles (generation << 32 | slot + 1).
+// lookup() is wait-free: it pins the slot with a reader count and checks the generation,
+// so a stale or forged handle is rejected even after its slot has been reused.
+// insert()/remove() serialize on a mutex; remove() waits for in-flight readers to drain
+// before handing the object back, so a Ref can never outlive the object it points at.
+template <class T, size_t Capacity>
+class HandleTable {
+    struct alignas(64) Slot {  // one cache line each so readers of different slots don't contend
+        std::atomic<T*> ptr{nullptr};
+        std::atomic<uint32_t> generation{1};
+        std::atomic<uint32_t> readers{0};
+    };
+
+public:
+    // RAII pin on a live entry. Keep it short-lived: remove() spins until it is released.
+    class Ref {
+    public:
+        Ref() = default;
+        Ref(Ref&& o) noexcept : _slot(o._slot), _obj(o._obj) { o._slot = nullptr; o._obj = nullptr; }
+        Ref& operator=(Ref&& o) noexcept {
+            if (this != &o) { release(); _slot = o._slot; _obj = o._obj; o._slot = nullptr; o._obj = nullptr; }
+            return *this;
+        }
+        Ref(const Ref&) = delete;
+        Ref& operator=(const Ref&) = delete;
+        ~Ref() { release(); }
+
+        T* get() const { return _obj; }
+        T* operator->() const { return _obj; }
+        T& operator*() const { return *_obj; }
+        explicit operator bool() const { return _obj != nullptr; }
+
+    private:
+        friend class HandleTable;
+        Ref(Slot* slot, T* obj) : _slot(slot), _obj(obj) {}
+        void release() {
+            if (_slot) _slot->readers.fetch_sub(1, std::memory_order_release);
+            _slot = nullptr;
+            _obj = nullptr;
+        }
+
+        Slot* _slot = nullptr;
+        T* _obj = nullptr;
+    };
+
+    HandleTable() = default;
+    HandleTable(const HandleTable&) = delete;
+    HandleTable& operator=(const HandleTable&) = delete;
+    ~HandleTable() {
+        for (auto& s : _slots) delete s.ptr.load();
+    }
+
+    // Returns 0 when the table is full.
+    uint64_t insert(std::unique_ptr<T> obj) {
+        std::lock_guard<std::mutex> lk(_mx);
+        uint32_t idx;
+        if (!_free.empty()) {
+            idx = _free.back();
+            _free.pop_back();
+        } else if (_next < Capacity) {
+            idx = _next++;
+        } else {
+            return 0;
+        }
+        Slot& s = _slots[idx];
+        const uint32_t gen = s.generation.load();
+        s.ptr.store(obj.release());
+        return (static_cast<uint64_t>(gen) << 32) | (idx + 1);
+    }
+
+    Ref lookup(uint64_t h) const {
+        Slot* s = slot_of(h);
+        if (!s) return Ref();
+        s->readers.fetch_add(1);  // seq_cst: pairs with the stores in remove()
+        T* obj = nullptr;
+        if (s->generation.load() == generation_of(h)) obj = s->ptr.load();
+        if (!obj) {
+            s->readers.fetch_sub(1, std::memory_order_release);
+            return Ref();
+        }
+        return Ref(s, obj);
+    }
+
+    // Invalidates `h` and returns its object once no reader holds it (nullptr if stale).
+    std::unique_ptr<T> remove(uint64_t h) {
+        Slot* s = slot_of(h);
+        if (!s) return nullptr;
+        T* obj = nullptr;
+        {
+            std::lock_guard<std::mutex> lk(_mx);
+            if (s->generation.load() != generation_of(h)) return nullptr;
+            obj = s->ptr.load();
+            if (!obj) return nullptr;
+            uint32_t next = generation_of(h) + 1;
+            s->generation.store(next ? next : 1);  // new lookups of `h` now fail
+            s->ptr.store(nullptr);
+        }
+        while (s->readers.load() != 0) std::this_thread::yield();  // seq_cst, see lookup()
+        {
+            std::lock_guard<std::mutex> lk(_mx);
+            _free.push_back(static_cast<uint32_t>(s - _slots));
+        }
+        return std::unique_ptr<T>(obj);
+    }
+
+private:
+    static uint32_t generation_of(uint64_t h) { return static_cast<uint32_t>(h >> 32); }
+
+    Slot* slot_of(uint64_t h) const {
+        const uint64_t idx = (h & 0xFFFFFFFFu);
+        if (idx == 0 || idx > Capacity) return nullptr;
+        return const_cast<Slot*>(&_slots[idx - 1]);
+    }
+
+    Slot _slots[Capacity];
+    mutable std::mutex _mx;
+    std::vector<uint32_t> _free;
+    uint32_t _next = 0;
+};
+
+} // namespace ubicoders_zenoh
@@ -0,0 +1,78 @@
+// key_table.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace ubicoders_zenoh {
+
+// A concrete key as handed to subscription callbacks. Interned keys live for the rest of
+// the process: `id` and the address of `name` never change, so callers can cache by id.
+struct InternedKey {
+    uint32_t id = 0;  // 1-based; 0 only for keys the full table could not take
+    std::string name;
+};
+
+// Process-wide interning table for sample keys. Lookups of known keys take a shared lock
+// on one of a few shards and allocate nothing. Keys are never removed, so the table is
+// capped: past kMaxKeys, intern() returns nullptr and the caller delivers an un-interned key.
+class KeyTable {
+public:
+    static constexpr size_t kMaxKeys = size_t(1) << 20;
+
+    static KeyTable& global() {
+        static KeyTable table;
+        return table;
+    }
+
+    const InternedKey* intern(std::string_view key) {
+        Shard& shard = _shards[std::hash<std::string_view>{}(key) % kShards];
+        {
+            std::shared_lock<std::shared_mutex> lk(shard.mx);
+            auto it = shard.map.find(key);
+            if (it != shard.map.end()) return it->second;
+        }
+        std::unique_lock<std::shared_mutex> lk(shard.mx);
+        auto it = shard.map.find(key);
+        if (it != shard.map.end()) return it->second;
+
+        const InternedKey* k;
+        {
+            std::lock_guard<std::mutex> keys_lk(_keys_mx);
+            if (_keys.size() >= kMaxKeys) return nullptr;
+            _keys.push_back(InternedKey{static_cast<uint32_t>(_keys.size() + 1), std::string(key)});
+            k = &_keys.back();  // deque: stable address
+        }
+        shard.map.emplace(std::string_view(k->name), k);
+        return k;
+    }
+
+    const InternedKey* find(uint32_t id) const {
+        std::lock_guard<std::mutex> lk(_keys_mx);
+        return (id >= 1 && id <= _keys.size()) ? &_keys[id - 1] : nullptr;
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lk(_keys_mx);
+        return _keys.size();
+    }
+
+private:
+    static constexpr size_t kShards = 16;
+    struct Shard {
+        std::shared_mutex mx;
+        std::unordered_map<std::string_view, const InternedKey*> map;  // views into _keys
+    };
+
+    Shard _shards[kShards];
+    mutable std::mutex _keys_mx;
+    std::deque<InternedKey> _keys;
+};
+
+} // namespace ubicoders_zenoh
@@ -1,61 +1,613 @@
 #include "node.h"
 #include <stdexcept>
+#include <exception>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+#include <random>
 
 using namespace zenoh;
 
 namespace ubicoders_zenoh {
 
-static Session open_default_session() {
-    Config cfg = Config::create_default();
+namespace {
+// Per-thread free list of scratch buffers for payloads that zenoh holds in several slices.
+// A list rather than a single buffer so a callback that re-enters delivery on the same
+// thread (e.g. publishes to a local subscriber) cannot clobber the outer view.
+thread_local std::vector<std::vector<uint8_t>> t_scratch;
+
+template <class F>
+void with_payload_view(const Bytes& bytes, F&& f) {
+    auto it = bytes.slice_iter();
+    auto first = it.next();
+    if (!first) { f(BytesView{}); return; }
+    if (first->len == bytes.size()) { f(BytesView{first->data, first->len}); return; }
+
+    std::vector<uint8_t> buf;
+    if (!t_scratch.empty()) {
+        buf = std::move(t_scratch.back());
+        t_scratch.pop_back();
+    }
+    buf.clear();
+    buf.reserve(bytes.size());
+    for (auto s = first; s; s = it.next()) buf.insert(buf.end(), s->data, s->data + s->len);
+
+    struct Recycle {
+        std::vector<uint8_t>& b;
+        ~Recycle() { t_scratch.push_back(std::move(b)); }
+    } recycle{buf};
+    f(BytesView{buf.data(), buf.size()});
+}
+
+template <class F>
+void with_query_payload(const Query& q, F&& f) {
+    if (auto pl = q.get_payload()) with_payload_view(pl->get(), f);
+    else f(BytesView{});
+}
+
+// Zero-copy payload over a cached reply, which it keeps alive
+zenoh::Bytes shared_bytes(const ReplyCache::Reply& reply) {
+    if (reply->empty()) return zenoh::Bytes();
+    return zenoh::Bytes(const_cast<uint8_t*>(reply->data()), reply->size(), [keep = reply](uint8_t*) {});
+}
+
+// False for plain samples; see SampleHeader
+bool read_sample_header(const Sample& s, SampleHeader& out) {
+    auto att = s.get_attachment();
+    if (!att || att->get().size() > SampleHeader::kMaxSize) return false;
+    uint8_t buf[SampleHeader::kMaxSize];
+    size_t n = 0;
+    auto it = att->get().slice_iter();
+    for (auto sl = it.next(); sl && n < sizeof(buf); sl = it.next()) {
+        const size_t take = std::min(sl->len, sizeof(buf) - n);
+        std::memcpy(buf + n, sl->data, take);
+        n += take;
+    }
+    return SampleHeader::decode(buf, n, out);
+}
+
+zenoh::Bytes encode_header(const SampleHeader& h) {
+    uint8_t buf[SampleHeader::kMaxSize];
+    return zenoh::Bytes(buf, h.encode(buf));
+}
+
+// Size of the application payload a sample of `len` bytes carries (part of)
+size_t payload_size(const SampleHeader& h, size_t len) {
+    if (h.delta) return h.delta->size;
+    if (h.compression) return h.compression->raw_size;
+    return len;
+}
+
+// Where a delta-mode publisher takes keyframe requests, under its own key. A verbatim chunk,
+// so wildcard subscribers and servers never see it.
+constexpr const char* kKeyframeSuffix = "/@keyframe";
+// Where a publisher with a last-value cache serves it
+constexpr const char* kLastValueSuffix = "/@last";
+
+// Decompresses into a pooled buffer and runs `f` on it; false if the payload is corrupt, too
+// large or uses a codec this build lacks
+template <class F>
+bool with_inflated(BlobPool& pool, const CompressionHeader& c, BytesView in, size_t max_size,
+                   EndpointStats& stats, F&& f) {
+    if (c.raw_size > max_size) return false;
+    auto buf = pool.acquire(c.raw_size);
+    const auto t0 = std::chrono::steady_clock::now();
+    const bool ok = decompress(c.codec, in.data, in.size, buf.data.get(), c.raw_size);
+    stats.codec_time.record(std::chrono::steady_clock::now() - t0);
+    struct Recycle {
+        BlobPool& pool;
+        BlobPool::Buffer& buf;
+        ~Recycle() { pool.release(std::move(buf)); }
+    } recycle{pool, buf};
+    if (!ok) return false;
+    stats.count_compressed(c.raw_size, in.size);
+    f(BytesView{buf.data.get(), c.raw_size});
+    return true;
+}
+
+// Runs a subscription's sink on one whole payload and counts its fate
+template <class Sink>
+void run_sink(const Sink& sink, EndpointStats& stats, const InternedKey& k, BytesView payload) {
+    stats.count(payload.size);
+    try {
+        if (!sink(k, payload)) stats.dropped.fetch_add(1, std::memory_order_relaxed);
+    } catch (...) {
+        stats.errors.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// Per-thread compression output, copied out at its final size
+thread_local std::vector<uint8_t> t_compress;
+
+// Adaptive compression: after this many payloads in a row that did not compress well
+// enough, only every kProbeEvery-th payload is tried until one does
+constexpr uint32_t kPoorRun = 8;
+constexpr uint32_t kProbeEvery = 16;
+
+// Best effort: the querier may already be gone, and there is nobody left to tell
+void reply_error(const Query& q, const std::string& message) {
+    try {
+        std::vector<uint8_t> eb(message.begin(), message.end());
+        q.reply_err(zenoh::Bytes(std::move(eb)), zenoh::Query::ReplyErrOptions{});
+    } catch (...) { }
+}
+} // namespace
+
+// Publisher-side pool of the shared-memory transport, shared by all handles of a node
+class ShmPool {
+public:
+#if ZNODE_HAS_SHM
+    ShmPool(size_t pool_bytes, size_t threshold)
+        : _provider(MemoryLayout(pool_bytes, AllocAlignment{0})), _threshold(threshold) {}
+
+    // Non-blocking: an exhausted pool makes the caller fall back to a heap payload
+    std::optional<ZShmMut> alloc(size_t len) const {
+        if (len < _threshold || len == 0) return std::nullopt;
+        auto r = _provider.alloc_gc_defrag(len, AllocAlignment{0});
+        if (auto* buf = std::get_if<ZShmMut>(&r)) return std::move(*buf);
+        return std::nullopt;
+    }
+
+private:
+    PosixShmProvider _provider;
+    size_t _threshold;
+#endif
+};
+
+static std::string json_string_array(const std::vector<std::string>& items) {
+    std::string out = "[";
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (i) out += ',';
+        out += '"';
+        for (char c : items[i]) {
+            if (c == '"' || c == '\\') out += '\\';
+            out += c;
+        }
+        out += '"';
+    }
+    return out + "]";
+}
+
+// Base config (file, inline JSON5 or zenoh defaults), then the preset and endpoints on top
+static Config make_config(const NodeOptions& options) {
+    Config cfg = !options.config_file.empty() ? Config::from_file(options.config_file)
+               : !options.config_json.empty() ? Config::from_str(options.config_json)
+               : Config::create_default();
+
+    std::vector<std::string> connect = options.connect;
+    std::vector<std::string> listen = options.listen;
+    switch (options.preset) {
+    case SessionPreset::Default:
+        break;
+    case SessionPreset::Loopback:
+        if (connect.empty()) connect.push_back("tcp/127.0.0.1:7447");
+        if (listen.empty()) listen.push_back("tcp/127.0.0.1:0");
+        cfg.insert_json5("scouting/multicast/enabled", "false");
+        cfg.insert_json5("scouting/delay", "0");
+        break;
+    case SessionPreset::FixedConnect:
+        if (connect.empty()) throw std::invalid_argument("SessionPreset::FixedConnect needs connect endpoints");
+        cfg.insert_json5("scouting/multicast/enabled", "false");
+        cfg.insert_json5("scouting/gossip/enabled", "false");
+        cfg.insert_json5("scouting/delay", "0");
+        break;
+    case SessionPreset::NoScouting:
+        cfg.insert_json5("scouting/multicast/enabled", "false");
+        cfg.insert_json5("scouting/gossip/enabled", "false");
+        cfg.insert_json5("scouting/delay", "0");
+        break;
+    }
+    if (!connect.empty()) cfg.insert_json5("connect/endpoints", json_string_array(connect));
+    if (!listen.empty()) cfg.insert_json5("listen/endpoints", json_string_array(listen));
+    return cfg;
+}
+
+static Session open_session(const NodeOptions& options = NodeOptions()) {
+    Config cfg = make_config(options);
+#if ZNODE_HAS_SHM
+    if (options.shared_memory) cfg.insert_json5("transport/shared_memory/enabled", "true");
+#else
+    (void)options;
+#endif
     return Session::open(std::move(cfg));
 }
 
+// Everything that shapes the session; nodes with equal fingerprints may share it
+static std::string session_fingerprint(const NodeOptions& o) {
+    std::string fp = o.config_file + '\n' + o.config_json + '\n' + std::to_string(static_cast<int>(o.preset));
+    for (auto& e : o.connect) fp += "\nc:" + e;
+    for (auto& e : o.listen) fp += "\nl:" + e;
+    fp += o.shared_memory ? "\nshm" : "";
+    return fp;
+}
+
+// Process-wide session pool. The pool only holds weak references, so a session closes with
+// the last node using it. Opening happens under the slot's own lock: a slow open for one
+// config does not hold up nodes with another.
+static std::shared_ptr<Session> acquire_session(const NodeOptions& options) {
+    if (!options.share_session) return std::make_shared<Session>(open_session(options));
+
+    struct Slot {
+        std::mutex mx;
+        std::weak_ptr<Session> session;
+    };
+    static std::mutex pool_mx;
+    static std::unordered_map<std::string, std::shared_ptr<Slot>> pool;
+
+    std::shared_ptr<Slot> slot;
+    {
+        std::lock_guard<std::mutex> lk(pool_mx);
+        for (auto it = pool.begin(); it != pool.end();) {  // forget closed sessions
+            if (it->second->session.expired() && it->second.use_count() == 1) it = pool.erase(it);
+            else ++it;
+        }
+        auto& s = pool[session_fingerprint(options)];
+        if (!s) s = std::make_shared<Slot>();
+        slot = s;
+    }
+    std::lock_guard<std::mutex> lk(slot->mx);
+    if (auto session = slot->session.lock()) return session;
+    auto session = std::make_shared<Session>(open_session(options));
+    slot->session = session;
+    return session;
+}
+
+static std::shared_ptr<ShmPool> make_shm_pool(const NodeOptions& options) {
+#if ZNODE_HAS_SHM
+    if (options.shared_memory)
+        return std::make_shared<ShmPool>(options.shm_pool_bytes, options.shm_threshold);
+#else
+    (void)options;
+#endif
+    return nullptr;
+}
+
 Node::Node() 
-    : _name(""), _session(open_default_session()) {}
+    : _session(acquire_session(NodeOptions())), _name("") {}
 
 Node::Node(const std::string& name) 
-    : _name(name), _session(open_default_session()) {}
+    : _session(acquire_session(NodeOptions())), _name(name) {}
+
+Node::Node(const std::string& name, const NodeOptions& options)
+    : _session(acquire_session(options)), _name(name), _options(options), _shm(make_shm_pool(options)) {}
     
 Node::~Node() { shutdown(); }
 
 void Node::shutdown() {
+    std::shared_ptr<Dispatcher> dispatcher;
+    std::unordered_map<std::string, std::shared_ptr<ServerQueue>> server_queues;
+    std::shared_ptr<TaskPool> query_pool;
+    {
+        std::lock_guard<std::mutex> lock(_mx);
+        for (auto& kv : _dispatch_queues) kv.second->close();  // release producers blocked on a full queue
+        _dispatch_queues.clear();
+        _subscribers.clear(); // undeclare before session dies
+        _latest.clear();
+        _publishers.clear();
+        _queriers.clear();    // gets in flight still complete through their callbacks
+        _stream_queriers.clear();
+        _servers.clear();     // no new deferred queries past this point
+        _stats.clear();
+        dispatcher = std::move(_dispatcher);
+        server_queues.swap(_server_queues);
+        query_pool = std::move(_query_pool);
+    }
+    // Outside _mx: running callbacks and handlers may call back into the node
+    if (dispatcher) dispatcher->stop();
+    for (auto& kv : server_queues) kv.second->close();  // queued queries get "error: shutdown"
+    if (query_pool) query_pool->stop();
+
+    // Stop the timer and fail whatever is still pending
+    std::unordered_map<uint64_t, PendingQuery> pending;
+    {
+        std::lock_guard<std::mutex> lk(_requests->mx);
+        _requests->stop = true;
+        pending.swap(_requests->pending);
+        _requests->deadlines = {};
+    }
+    _requests->timer_cv.notify_all();
+    if (_timer.joinable()) _timer.join();
+    for (auto& kv : pending) {
+        reply_error(kv.second.query, "error: shutdown");
+        if (kv.second.cache) kv.second.cache->fail(kv.second.cache_key, "error: shutdown");
+    }
+}
+
+void ubicoders_zenoh::Node::create_server(const std::string& key, QueryHandler handler,
+                                         const ServerOptions& opts) {
+    create_view_server(key,
+        [handler = std::move(handler)](const std::string& k, const std::string& params,
+                                       BytesView payload) {
+            return handler(k, params, payload.to_vector());
+        }, opts);
+}
+
+void ubicoders_zenoh::Node::create_view_server(const std::string& key, QueryViewHandler handler,
+                                              const ServerOptions& opts) {
     std::lock_guard<std::mutex> lock(_mx);
-    _subscribers.clear(); // undeclare before session dies
-    _publishers.clear();
+    if (_servers.count(key)) return;
+    auto stats = add_stats_locked(EndpointKind::Server, key);
+    auto cache = opts.cache.ttl.count() > 0 ? std::make_shared<ReplyCache>(opts.cache) : nullptr;
+
+    // Runs the handler and sends its reply, or an error reply if it throws. With a cache the
+    // query leads the miss `cache_key`, and the queries parked on it get the same outcome.
+    auto answer = [key, handler, stats, cache](const Query& q, const std::string& params, BytesView in,
+                                               const std::string& cache_key) {
+        const auto t0 = std::chrono::steady_clock::now();
+        std::string error;
+        try {
+            std::vector<uint8_t> out = handler(key, params, in);
+            if (cache) {
+                auto reply = std::make_shared<const std::vector<uint8_t>>(std::move(out));
+                q.reply(make_keyexpr(key), shared_bytes(reply), zenoh::Query::ReplyOptions{});
+                cache->complete(cache_key, std::move(reply));
+            } else {
+                q.reply(make_keyexpr(key), zenoh::Bytes(std::move(out)), zenoh::Query::ReplyOptions{});
+            }
+        } catch (const std::exception& e) {
+            error = std::string("error: ") + e.what();
+        } catch (...) {
+            error = "error";
+        }
+        if (!error.empty()) {
+            stats->errors.fetch_add(1, std::memory_order_relaxed);
+            reply_error(q, error);
+            if (cache) cache->fail(cache_key, error);
+        }
+        stats->latency.record(std::chrono::steady_clock::now() - t0);
+    };
+    declare_server_locked(key, opts, std::move(stats), std::move(cache), std::move(answer));
+}
+
+// Shared stream of one query: replies are serialized, and the query is finalized (the
+// client's get ends) once the stream is closed or the last sink copy goes away.
+struct ReplySink::State {
+    std::mutex mx;
+    std::optional<Query> query;  // empty once the stream ended
+    zenoh::KeyExpr key;
+    std::shared_ptr<EndpointStats> stats;
+    std::chrono::steady_clock::time_point started;
+    uint32_t sent = 0;
+
+    State(const Query& q, const std::string& k, std::shared_ptr<EndpointStats> st)
+        : query(q.clone()), key(k.c_str()), stats(std::move(st)), started(std::chrono::steady_clock::now()) {}
+    ~State() { close_locked(); }
+
+    void close_locked() {
+        if (!query) return;
+        query.reset();
+        stats->latency.record(std::chrono::steady_clock::now() - started);
+    }
+};
+
+bool ReplySink::reply(zenoh::Bytes&& payload) {
+    std::lock_guard<std::mutex> lk(_state->mx);
+    if (!_state->query) return false;
+    try {
+        _state->query->reply(_state->key, std::move(payload), zenoh::Query::ReplyOptions{});
+    } catch (...) {
+        // The querier is gone or the session closed: nothing further can reach the client
+        _state->stats->errors.fetch_add(1, std::memory_order_relaxed);
+        _state->close_locked();
+        return false;
+    }
+    ++_state->sent;
+    return true;
 }
 
-void ubicoders_zenoh::Node::create_server(const std::string& key, QueryHandler handler) {
+bool ReplySink::send(const uint8_t* data, size_t len) {
+    return reply(len ? zenoh::Bytes(data, len) : zenoh::Bytes());
+}
+
+bool ReplySink::send(std::vector<uint8_t>&& data) {
+    return reply(zenoh::Bytes(std::move(data)));
+}
+
+bool ReplySink::fail(const std::string& message) {
+    std::lock_guard<std::mutex> lk(_state->mx);
+    if (!_state->query) return false;
+    _state->stats->errors.fetch_add(1, std::memory_order_relaxed);
+    reply_error(*_state->query, message);
+    _state->close_locked();
+    return true;
+}
+
+void ReplySink::finish() {
+    std::lock_guard<std::mutex> lk(_state->mx);
+    _state->close_locked();
+}
+
+bool ReplySink::open() const {
+    std::lock_guard<std::mutex> lk(_state->mx);
+    return _state->query.has_value();
+}
+
+uint32_t ReplySink::sent() const {
+    std::lock_guard<std::mutex> lk(_state->mx);
+    return _state->sent;
+}
+
+void Node::create_streaming_server(const std::string& key, StreamingQueryHandler handler,
+                                   const ServerOptions& opts) {
     std::lock_guard<std::mutex> lock(_mx);
     if (_servers.count(key)) return;
+    auto stats = add_stats_locked(EndpointKind::Server, key);
+
+    // Latency is recorded when the stream ends, which may be after the handler returned
+    auto serve = [key, handler, stats](const Query& q, const std::string& params, BytesView in,
+                                       const std::string&) {
+        ReplySink sink(std::make_shared<ReplySink::State>(q, key, stats));
+        try {
+            handler(key, params, in, sink);
+        } catch (const std::exception& e) {
+            sink.fail(std::string("error: ") + e.what());
+        } catch (...) {
+            sink.fail("error");
+        }
+    };
+    declare_server_locked(key, opts, std::move(stats), nullptr, std::move(serve));
+}
+
+// Declares the queryable behind create_view_server / create_streaming_server: consults the
+// cache, then runs `serve` inline or through the server's queue as `opts.execution` says.
+void Node::declare_server_locked(const std::string& key, const ServerOptions& opts,
+                                 std::shared_ptr<EndpointStats> stats, std::shared_ptr<ReplyCache> cache,
+                                 ServeFn serve) {
+    std::function<void(const Query&)> on_query;
+    if (opts.execution == ServerExecution::Inline) {
+        // Per-query callback (runs on a zenoh thread)
+        on_query = [key, serve, stats, cache](const Query& q) {
+            try {
+                with_query_payload(q, [&](BytesView in) {
+                    stats->count(in.size);
+                    std::string cache_key;
+                    if (cache && !cache_front(*cache, q, key, in, *stats, cache_key)) return;
+                    serve(q, std::string(q.get_parameters()), in, cache_key);
+                });
+            } catch (...) {
+                stats->errors.fetch_add(1, std::memory_order_relaxed);
+                reply_error(q, "error");
+            }
+        };
+    } else {
+        // Per-query callback (runs on a zenoh thread): copy the query out and queue it, or
+        // shed it right away when the server is saturated
+        auto queue = make_server_queue_locked(opts);
+        _server_queues[key] = queue;
+        on_query = [key, serve, stats, cache, queue, overload = opts.overload_reply](const Query& q) {
+            struct Queued {
+                Query query;
+                std::string params;
+                std::vector<uint8_t> payload;
+                std::string cache_key;
+                std::chrono::steady_clock::time_point arrived;
+            };
+            try {
+                with_query_payload(q, [&](BytesView in) {
+                    stats->count(in.size);
+                    std::string cache_key;
+                    if (cache && !cache_front(*cache, q, key, in, *stats, cache_key)) return;
+                    auto job = std::make_shared<Queued>(Queued{q.clone(), std::string(q.get_parameters()),
+                                                               in.to_vector(), std::move(cache_key),
+                                                               std::chrono::steady_clock::now()});
+                    const bool queued = queue->submit([serve, stats, cache, job](bool cancelled) {
+                        if (cancelled) {
+                            reply_error(job->query, "error: shutdown");
+                            if (cache) cache->fail(job->cache_key, "error: shutdown");
+                            return;
+                        }
+                        stats->queue_wait.record(std::chrono::steady_clock::now() - job->arrived);
+                        serve(job->query, job->params, BytesView{job->payload.data(), job->payload.size()},
+                              job->cache_key);
+                    });
+                    if (!queued) {
+                        stats->dropped.fetch_add(1, std::memory_order_relaxed);
+                        reply_error(q, overload);
+                        if (cache) cache->fail(job->cache_key, overload);
+                    }
+                });
+            } catch (...) {
+                stats->errors.fetch_add(1, std::memory_order_relaxed);
+                reply_error(q, "error");
+            }
+        };
+    }
 
     auto qable = std::make_shared<Queryable<void>>(
-        _session.declare_queryable(
+        _session->declare_queryable(make_keyexpr(key), std::move(on_query), closures::none));
+    _servers.emplace(key, std::move(qable));
+}
+
+// Reply-cache front, on the zenoh thread: answers hits and parks queries that duplicate a
+// miss already being handled. Returns true only for a query that must run the handler; it
+// then has to end in cache.complete or cache.fail under `cache_key`.
+bool Node::cache_front(ReplyCache& cache, const Query& q, const std::string& key, BytesView payload,
+                       EndpointStats& stats, std::string& cache_key) {
+    cache_key = ReplyCache::make_key(q.get_keyexpr().as_string_view(), q.get_parameters(), payload);
+    ReplyCache::Reply hit;
+    const auto outcome = cache.lookup(cache_key, hit, [&]() -> ReplyCache::Waiter {
+        auto parked = std::make_shared<Query>(q.clone());
+        return [parked, key](const ReplyCache::Reply& reply, const std::string& error) {
+            if (!reply) {
+                reply_error(*parked, error);
+                return;
+            }
+            try {
+                parked->reply(make_keyexpr(key), shared_bytes(reply), zenoh::Query::ReplyOptions{});
+            } catch (...) { }
+        };
+    });
+    if (outcome == ReplyCache::Lookup::Leader) return true;
+    stats.cache_hits.fetch_add(1, std::memory_order_relaxed);
+    if (outcome == ReplyCache::Lookup::Hit) {
+        try {
+            q.reply(make_keyexpr(key), shared_bytes(hit), zenoh::Query::ReplyOptions{});
+        } catch (...) {
+            stats.errors.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    return false;
+}
+
+std::shared_ptr<ServerQueue> Node::make_server_queue_locked(const ServerOptions& opts) {
+    if (opts.execution == ServerExecution::Dedicated) {
+        auto pool = std::make_shared<TaskPool>(opts.max_concurrency);
+        return std::make_shared<ServerQueue>(std::move(pool), true, opts.max_concurrency, opts.queue_depth);
+    }
+    if (!_query_pool) {
+        size_t threads = _options.query_threads;
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        _query_pool = std::make_shared<TaskPool>(threads);
+    }
+    return std::make_shared<ServerQueue>(_query_pool, false, opts.max_concurrency, opts.queue_depth);
+}
+
+void Node::create_deferred_server(const std::string& key, DeferredQueryHandler handler,
+                                  std::chrono::milliseconds timeout, const ReplyCacheOptions& cache_opts) {
+    {
+        std::lock_guard<std::mutex> lk(_requests->mx);
+        _requests->stop = false;
+        if (!_timer.joinable()) _timer = std::thread([this] { timer_loop(); });
+    }
+
+    std::lock_guard<std::mutex> lock(_mx);
+    if (_servers.count(key)) return;
+    auto stats = add_stats_locked(EndpointKind::Server, key);
+    auto cache = cache_opts.ttl.count() > 0 ? std::make_shared<ReplyCache>(cache_opts) : nullptr;
+
+    auto qable = std::make_shared<Queryable<void>>(
+        _session->declare_queryable(
             make_keyexpr(key),
-            // Per-query callback (runs on a zenoh thread)
-            [this, key, handler](const Query& q) {
-                try {
-                    // Extract payload (optional)
-                    std::vector<uint8_t> in;
-                    if (auto pl = q.get_payload()) {
-                        // Bytes -> std::string (binary-safe), then to vector<uint8_t>
-                        const std::string bin = pl->get().as_string();
-                        in.assign(bin.begin(), bin.end());
+            // Per-query callback (runs on a zenoh thread): park the query and return.
+            // Cache hits and duplicates of a parked miss never reach the handler.
+            [requests = _requests, key, handler, timeout, stats, cache](const Query& q) {
+                const uint64_t id = requests->next_id.fetch_add(1, std::memory_order_relaxed);
+                const auto now = std::chrono::steady_clock::now();
+                with_query_payload(q, [&](BytesView in) {
+                    stats->count(in.size);
+                    std::string cache_key;
+                    if (cache && !cache_front(*cache, q, key, in, *stats, cache_key)) return;
+                    {
+                        std::lock_guard<std::mutex> lk(requests->mx);
+                        if (requests->stop) {
+                            reply_error(q, "error: shutdown");
+                            if (cache) cache->fail(cache_key, "error: shutdown");
+                            return;
+                        }
+                        const auto deadline = now + timeout;
+                        const bool earliest = requests->deadlines.empty() || deadline < requests->deadlines.top().first;
+                        requests->pending.emplace(id, PendingQuery{q.clone(), key, now, stats, cache, std::move(cache_key)});
+                        requests->deadlines.emplace(deadline, id);
+                        if (earliest) requests->timer_cv.notify_one();
                     }
-                    // Parameters (string_view -> string)
-                    std::string params(q.get_parameters());
-
-                    // Produce reply and send
-                    std::vector<uint8_t> out = handler(key, params, in);
-                    q.reply(make_keyexpr(key), zenoh::Bytes(out), zenoh::Query::ReplyOptions{});
-                } catch (const std::exception& e) {
-                    const std::string emsg = std::string("error: ") + e.what();
-                    std::vector<uint8_t> eb(emsg.begin(), emsg.end());
-                    q.reply_err(zenoh::Bytes(eb), zenoh::Query::ReplyErrOptions{});
-                } catch (...) {
-                    const std::string emsg = "error";
-                    std::vector<uint8_t> eb(emsg.begin(), emsg.end());
-                    q.reply_err(zenoh::Bytes(eb), zenoh::Query::ReplyErrOptions{});
-                }
+                    try {
+                        handler(id, key, std::string(q.get_parameters()), in);
+                    } catch (const std::exception& e) {
+                        requests->fail(id, e.what());
+                    } catch (...) {
+                        requests->fail(id, "");
+                    }
+                });
             },
             closures::none
         )
@@ -64,14 +616,151 @@ void ubicoders_zenoh::Node::create_server(const std::string& key, QueryHandler h
     _servers.emplace(key, std::move(qable));
 }
 
+std::optional<Node::PendingQuery> Node::RequestTable::take(uint64_t request_id) {
+    std::lock_guard<std::mutex> lk(mx);
+    auto it = pending.find(request_id);
+    if (it == pending.end()) return std::nullopt;
+    std::optional<PendingQuery> out(std::move(it->second));
+    pending.erase(it);
+    return out;  // its deadline entry is skipped by the timer once it fires
+}
+
+bool Node::RequestTable::fail(uint64_t request_id, const std::string& message) {
+    auto p = take(request_id);
+    if (!p) return false;
+    p->stats->errors.fetch_add(1, std::memory_order_relaxed);
+    p->stats->latency.record(std::chrono::steady_clock::now() - p->arrived);
+    const std::string error = message.empty() ? std::string("error") : "error: " + message;
+    reply_error(p->query, error);
+    if (p->cache) p->cache->fail(p->cache_key, error);
+    return true;
+}
+
+bool Node::complete_request(uint64_t request_id, const uint8_t* data, size_t len) {
+    auto p = _requests->take(request_id);
+    if (!p) return false;
+    try {
+        if (p->cache) {
+            auto reply = std::make_shared<const std::vector<uint8_t>>(data, data + len);
+            p->query.reply(make_keyexpr(p->key), shared_bytes(reply), zenoh::Query::ReplyOptions{});
+            p->cache->complete(p->cache_key, std::move(reply));
+        } else {
+            p->query.reply(make_keyexpr(p->key), zenoh::Bytes(data, len), zenoh::Query::ReplyOptions{});
+        }
+    } catch (const std::exception& e) {
+        p->stats->errors.fetch_add(1, std::memory_order_relaxed);
+        const std::string error = std::string("error: ") + e.what();
+        reply_error(p->query, error);
+        if (p->cache) p->cache->fail(p->cache_key, error);
+    }
+    p->stats->latency.record(std::chrono::steady_clock::now() - p->arrived);
+    return true;
+}
+
+bool Node::fail_request(uint64_t request_id, const std::string& message) {
+    return _requests->fail(request_id, message);
+}
+
+bool Node::reply_partial(uint64_t request_id, const uint8_t* data, size_t len) {
+    std::optional<Query> q;
+    std::shared_ptr<EndpointStats> stats;
+    std::string key;
+    {
+        std::lock_guard<std::mutex> lk(_requests->mx);
+        auto it = _requests->pending.find(request_id);
+        if (it == _requests->pending.end() || it->second.cache) return false;
+        q.emplace(it->second.query.clone());  // reply outside the lock; the query stays pending
+        stats = it->second.stats;
+        key = it->second.key;
+    }
+    try {
+        q->reply(make_keyexpr(key), zenoh::Bytes(data, len), zenoh::Query::ReplyOptions{});
+    } catch (...) {
+        stats->errors.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+bool Node::finish_request(uint64_t request_id) {
+    auto p = _requests->take(request_id);
+    if (!p) return false;
+    p->stats->latency.record(std::chrono::steady_clock::now() - p->arrived);
+    if (p->cache) p->cache->fail(p->cache_key, "error: no reply");
+    return true;  // dropping the query finalizes it for the client
+}
+
+void Node::timer_loop() {
+    RequestTable& r = *_requests;
+    const auto sweep_every = std::max(_options.reassembly.timeout, std::chrono::milliseconds(10));
+    auto next_sweep = std::chrono::steady_clock::now() + sweep_every;
+    std::unique_lock<std::mutex> lk(r.mx);
+    while (!r.stop) {
+        const auto now = std::chrono::steady_clock::now();
+        std::vector<PendingQuery> expired;
+        while (!r.deadlines.empty() && r.deadlines.top().first <= now) {
+            auto it = r.pending.find(r.deadlines.top().second);
+            r.deadlines.pop();
+            if (it == r.pending.end()) continue;  // already answered
+            it->second.stats->timeouts.fetch_add(1, std::memory_order_relaxed);
+            expired.push_back(std::move(it->second));
+            r.pending.erase(it);
+        }
+        if (!expired.empty()) {
+            // Reply outside the lock; dropping each Query finalizes it for the client
+            lk.unlock();
+            for (auto& p : expired) {
+                reply_error(p.query, "error: timeout");
+                if (p.cache) p.cache->fail(p.cache_key, "error: timeout");
+            }
+            expired.clear();
+            lk.lock();
+            continue;
+        }
+        if (!r.sweeps.empty() && now >= next_sweep) {
+            // A transfer only times out in add() when a later fragment arrives; this frees the
+            // buffer of one whose publisher stopped mid-way
+            next_sweep = now + sweep_every;
+            const std::vector<RequestTable::Sweep> sweeps = r.sweeps;
+            lk.unlock();
+            for (const auto& w : sweeps) {
+                auto fragments = w.fragments.lock();
+                const size_t lost = fragments ? fragments->sweep() : 0;
+                auto stats = w.stats.lock();
+                if (lost && stats) stats->dropped.fetch_add(lost, std::memory_order_relaxed);
+            }
+            lk.lock();
+            continue;
+        }
+        if (r.deadlines.empty() && r.sweeps.empty()) {
+            r.timer_cv.wait(lk);
+        } else {
+            // Copy: pushes while waiting may reallocate
+            auto next = r.deadlines.empty() ? next_sweep : r.deadlines.top().first;
+            if (!r.sweeps.empty()) next = std::min(next, next_sweep);
+            r.timer_cv.wait_until(lk, next);
+        }
+    }
+}
+
 
 void ubicoders_zenoh::Node::remove_server(const std::string& key) {
-    std::lock_guard<std::mutex> lock(_mx);
-    auto it = _servers.find(key);
-    if (it != _servers.end()) {
-        it->second.reset(); // undeclare
-        _servers.erase(it);
+    std::shared_ptr<ServerQueue> queue;
+    {
+        std::lock_guard<std::mutex> lock(_mx);
+        auto it = _servers.find(key);
+        if (it != _servers.end()) {
+            it->second.reset(); // undeclare
+            _servers.erase(it);
+        }
+        auto q = _server_queues.find(key);
+        if (q != _server_queues.end()) {
+            queue = std::move(q->second);
+            _server_queues.erase(q);
+        }
+        _stats.erase({EndpointKind::Server, key});
     }
+    if (queue) queue->close();  // outside _mx: joins a dedicated pool's running handlers
 }
 
 
@@ -84,29 +773,561 @@ bool Node::has_publisher(const std::string& key) const {
     return _publishers.find(key) != _publishers.end();
 }
 
-void Node::create_publisher(const std::string& key) {
+PublisherHandle::PublisherHandle(std::string key, Publisher&& pub, std::shared_ptr<EndpointStats> stats,
+                                 std::shared_ptr<ShmPool> shm, const PublisherOptions& opts)
+    : _key(std::move(key)), _pub(std::move(pub)), _stats(std::move(stats)), _shm(std::move(shm)),
+      _fragment_bytes(opts.fragment_bytes), _compression(opts.compression), _delta_opts(opts.delta),
+      _stamp(opts.stamp || opts.last_value_cache) {
+    if (!compression_available(_compression.codec)) _compression.codec = Compression::None;
+    if (_delta_opts.keyframe_interval) _delta = std::make_shared<DeltaState>();
+    if (opts.last_value_cache) _retained = std::make_shared<Retained>();
+    if (_fragment_bytes || _delta || _stamp) {
+        std::random_device rd;
+        _source = (static_cast<uint64_t>(rd()) << 32) ^ rd();
+    }
+}
+
+void PublisherHandle::put(zenoh::Bytes&& payload, const SampleHeader& header) const {
+    const size_t n = payload.size();
+    try {
+        if (header.empty()) {
+            _pub.put(std::move(payload));
+        } else {
+            Publisher::PutOptions opts;
+            opts.attachment = encode_header(header);
+            _pub.put(std::move(payload), std::move(opts));
+        }
+    } catch (...) {
+        _stats->errors.fetch_add(1, std::memory_order_relaxed);
+        throw;
+    }
+    _stats->count(payload_size(header, n));
+}
+
+// One sample per fragment, each tagged with its FragmentHeader; counted once as a whole
+void PublisherHandle::put_fragments(const uint8_t* data, size_t len, std::shared_ptr<const void> keep,
+                                    SampleHeader header) const {
+    if (len > std::numeric_limits<uint32_t>::max()) throw std::length_error("payload too large to fragment");
+    FragmentHeader& h = header.fragment.emplace();
+    h.source = _source;
+    h.transfer = _transfers.fetch_add(1, std::memory_order_relaxed);
+    h.total = static_cast<uint32_t>(len);
+    try {
+        for (size_t off = 0; off < len; off += _fragment_bytes) {
+            const size_t n = std::min(_fragment_bytes, len - off);
+            h.offset = static_cast<uint32_t>(off);
+            Publisher::PutOptions opts;
+            opts.attachment = encode_header(header);
+            uint8_t* part = const_cast<uint8_t*>(data) + off;
+            _pub.put(keep ? zenoh::Bytes(part, n, [keep](uint8_t*) {}) : zenoh::Bytes(part, n), std::move(opts));
+        }
+    } catch (...) {
+        _stats->errors.fetch_add(1, std::memory_order_relaxed);
+        throw;
+    }
+    _stats->count(payload_size(header, len));
+}
+
+bool PublisherHandle::put_compressed(const uint8_t* data, size_t len, SampleHeader header) const {
+    const CompressionOptions& c = _compression;
+    if (c.codec == Compression::None || len < c.threshold || len > std::numeric_limits<uint32_t>::max())
+        return false;
+    if (_poor_run.load(std::memory_order_relaxed) >= kPoorRun &&
+        _probe.fetch_add(1, std::memory_order_relaxed) % kProbeEvery != 0)
+        return false;
+
+    const size_t cap = compress_bound(c.codec, len);
+    if (t_compress.size() < cap) t_compress.resize(cap);
+    const auto t0 = std::chrono::steady_clock::now();
+    const size_t n = compress(c.codec, c.level, data, len, t_compress.data(), cap);
+    _stats->codec_time.record(std::chrono::steady_clock::now() - t0);
+    if (n == 0 || static_cast<double>(n) > static_cast<double>(len) * (1.0 - c.min_saving)) {
+        _poor_run.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    _poor_run.store(0, std::memory_order_relaxed);
+
+    header.compression = CompressionHeader{c.codec, static_cast<uint32_t>(len)};
+    auto wire = std::make_shared<const std::vector<uint8_t>>(t_compress.begin(), t_compress.begin() + n);
+    if (fragmented(n)) put_fragments(wire->data(), n, wire, header);
+    else put(zenoh::Bytes(const_cast<uint8_t*>(wire->data()), n, [wire](uint8_t*) {}), header);
+    _stats->count_compressed(len, n);
+    return true;
+}
+
+void PublisherHandle::put_tagged(const uint8_t* data, size_t len, const SampleHeader& header) const {
+    if (put_compressed(data, len, header)) return;
+    if (fragmented(len)) return put_fragments(data, len, nullptr, header);
+    put(zenoh::Bytes(data, len), header);
+}
+
+bool PublisherHandle::put_delta(const uint8_t* data, size_t len) const {
+    if (!_delta) return false;
+    if (len > std::numeric_limits<uint32_t>::max()) throw std::length_error("payload too large for delta mode");
+    DeltaState& d = *_delta;
+    std::lock_guard<std::mutex> lk(d.mx);
+    const bool requested = d.keyframe_requested.exchange(false, std::memory_order_relaxed);
+    bool keyframe = !d.started || requested || len != d.prev.size() ||
+                    d.since_keyframe + 1 >= _delta_opts.keyframe_interval;
+    size_t n = 0;
+    if (!keyframe) {
+        const size_t cap = static_cast<size_t>(static_cast<double>(len) * _delta_opts.max_delta_ratio);
+        if (d.scratch.size() < cap) d.scratch.resize(cap);
+        keyframe = !delta_encode(d.prev.data(), data, len, d.scratch.data(), cap, n);
+    }
+
+    SampleHeader header = stamped();
+    header.delta = DeltaHeader{keyframe, _source, d.seq + 1, static_cast<uint32_t>(len)};
+    try {
+        if (keyframe) put_tagged(data, len, header);
+        else put_tagged(d.scratch.data(), n, header);
+    } catch (...) {
+        if (requested) d.keyframe_requested.store(true, std::memory_order_relaxed);
+        throw;
+    }
+    // Only a sample that went out becomes the base, so a failed put leaves no gap behind
+    ++d.seq;
+    d.started = true;
+    d.since_keyframe = keyframe ? 0 : d.since_keyframe + 1;
+    d.prev.assign(data, data + len);
+    // After the put: a cached keyframe must carry a sequence number that went out
+    header.delta->keyframe = true;
+    retain(data, len, header);
+    if (keyframe) _stats->keyframes.fetch_add(1, std::memory_order_relaxed);
+    else _stats->count_delta(len, n);
+    return true;
+}
+
+// In shared-memory mode the one copy goes into the pool instead of a heap buffer, and
+// local subscribers then map it rather than receive it through the socket stack
+bool PublisherHandle::put_shm(const uint8_t* data, size_t len, const SampleHeader& header) const {
+#if ZNODE_HAS_SHM
+    if (!_shm) return false;
+    auto buf = _shm->alloc(len);
+    if (!buf) return false;
+    std::memcpy(buf->data(), data, len);
+    put(zenoh::Bytes(std::move(*buf)), header);
+    return true;
+#else
+    (void)data; (void)len; (void)header;
+    return false;
+#endif
+}
+
+void PublisherHandle::retain(const uint8_t* data, size_t len, const SampleHeader& header) const {
+    if (!_retained) return;
+    std::lock_guard<std::mutex> lk(_retained->mx);
+    _retained->payload.assign(data, data + len);
+    _retained->header = SampleHeader();
+    _retained->header.stamp = header.stamp;
+    _retained->header.delta = header.delta;
+    _retained->set = true;
+}
+
+SampleHeader PublisherHandle::stamped() const {
+    SampleHeader h;
+    if (_stamp) {
+        const auto now = std::chrono::system_clock::now().time_since_epoch();
+        h.stamp = StampHeader{_source, _stamps.fetch_add(1, std::memory_order_relaxed) + 1,
+                              static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count())};
+    }
+    return h;
+}
+
+PublisherHandle::Publishing::Publishing(const PublisherHandle& pub, const uint8_t* data, size_t len)
+    : _pub(pub), _exceptions(std::uncaught_exceptions()) {
+    if (pub._retained) {
+        _order = std::unique_lock<std::mutex>(pub._retained->order);
+        pub._retained->staged.assign(data, data + len);
+    }
+    _header = pub.stamped();
+}
+
+PublisherHandle::Publishing::~Publishing() {
+    if (!_order.owns_lock() || std::uncaught_exceptions() > _exceptions) return;  // failed: keep the old value
+    Retained& r = *_pub._retained;
+    std::lock_guard<std::mutex> lk(r.mx);
+    r.payload.swap(r.staged);
+    r.header = SampleHeader();
+    r.header.stamp = _header.stamp;
+    r.set = true;
+}
+
+void PublisherHandle::publish(const std::vector<uint8_t>& data) const {
+    if (put_delta(data.data(), data.size())) return;
+    const Publishing publishing(*this, data.data(), data.size());
+    const SampleHeader& header = publishing.header();
+    if (put_compressed(data.data(), data.size(), header)) return;
+    if (fragmented(data.size())) return put_fragments(data.data(), data.size(), nullptr, header);
+    if (put_shm(data.data(), data.size(), header)) return;
+    put(zenoh::Bytes(data), header);
+}
+
+void PublisherHandle::publish(std::vector<uint8_t>&& data) const {
+    if (put_delta(data.data(), data.size())) return;
+    const Publishing publishing(*this, data.data(), data.size());
+    const SampleHeader& header = publishing.header();
+    if (put_compressed(data.data(), data.size(), header)) return;
+    if (fragmented(data.size())) {
+        auto owned = std::make_shared<const std::vector<uint8_t>>(std::move(data));
+        return put_fragments(owned->data(), owned->size(), owned, header);
+    }
+    if (put_shm(data.data(), data.size(), header)) return;
+    put(zenoh::Bytes(std::move(data)), header);
+}
+
+void PublisherHandle::publish(const uint8_t* data, size_t len) const {
+    if (put_delta(data, len)) return;
+    const Publishing publishing(*this, data, len);
+    const SampleHeader& header = publishing.header();
+    if (put_compressed(data, len, header)) return;
+    if (fragmented(len)) return put_fragments(data, len, nullptr, header);
+    if (put_shm(data, len, header)) return;
+    put(zenoh::Bytes(data, len), header);
+}
+
+LoanedBuffer PublisherHandle::loan(size_t len) const {
+#if ZNODE_HAS_SHM
+    if (_shm && !_delta) {  // delta mode copies the payload anyway
+        if (auto buf = _shm->alloc(len)) return LoanedBuffer(std::move(*buf));
+    }
+#endif
+    return LoanedBuffer(std::vector<uint8_t>(len));
+}
+
+void PublisherHandle::publish(LoanedBuffer&& buf) const {
+#if ZNODE_HAS_SHM
+    if (auto* shm = std::get_if<ZShmMut>(&buf._buf)) {
+        const Publishing publishing(*this, shm->data(), shm->len());
+        put(zenoh::Bytes(std::move(*shm)), publishing.header());
+        return;
+    }
+#endif
+    auto& heap = std::get<std::vector<uint8_t>>(buf._buf);
+    if (put_delta(heap.data(), heap.size())) return;
+    const Publishing publishing(*this, heap.data(), heap.size());
+    const SampleHeader& header = publishing.header();
+    if (put_compressed(heap.data(), heap.size(), header)) return;
+    if (fragmented(heap.size())) {
+        auto owned = std::make_shared<const std::vector<uint8_t>>(std::move(heap));
+        return put_fragments(owned->data(), owned->size(), owned, header);
+    }
+    put(zenoh::Bytes(std::move(heap)), header);
+}
+
+uint8_t* LoanedBuffer::data() {
+#if ZNODE_HAS_SHM
+    if (auto* shm = std::get_if<ZShmMut>(&_buf)) return shm->data();
+#endif
+    return std::get<std::vector<uint8_t>>(_buf).data();
+}
+
+size_t LoanedBuffer::size() const {
+#if ZNODE_HAS_SHM
+    if (auto* shm = std::get_if<ZShmMut>(&_buf)) return shm->len();
+#endif
+    return std::get<std::vector<uint8_t>>(_buf).size();
+}
+
+bool LoanedBuffer::shared_memory() const {
+    return _buf.index() != 0;
+}
+
+void PublisherHandle::publish_borrowed(const uint8_t* data, size_t len,
+                                       ReleaseCallback release) const {
+    std::optional<Publishing> publishing;  // put_delta stamps and retains its own
+    try {
+        if (!_delta) publishing.emplace(*this, data, len);  // copies into the cache: may throw
+    } catch (...) {
+        if (release) release(data);
+        throw;
+    }
+    const SampleHeader header = publishing ? publishing->header() : SampleHeader();
+    if (_delta || _compression.codec != Compression::None) {
+        // A delta or compressed copy no longer needs the caller's buffer
+        bool sent = false;
+        try {
+            sent = put_delta(data, len) || put_compressed(data, len, header);
+        } catch (...) {
+            if (release) release(data);
+            throw;
+        }
+        if (sent) {
+            if (release) release(data);
+            return;
+        }
+    }
+    if (fragmented(len)) {
+        // Released once zenoh is done with the last fragment, or right away on failure
+        std::shared_ptr<const void> keep(data, [release = std::move(release)](const void* p) {
+            if (release) release(static_cast<const uint8_t*>(p));
+        });
+        return put_fragments(data, len, std::move(keep), header);
+    }
+    // zenoh only reads the buffer; the deleter hands it back to the caller
+    zenoh::Bytes payload(const_cast<uint8_t*>(data), len,
+                         [release = std::move(release)](void* p) {
+                             if (release) release(static_cast<const uint8_t*>(p));
+                         });
+    put(std::move(payload), header);
+}
+
+void Node::create_publisher(const std::string& key, const PublisherOptions& opts) {
+    declare_publisher(key, opts);
+}
+
+std::shared_ptr<PublisherHandle> Node::declare_publisher(const std::string& key, const PublisherOptions& opts) {
     std::lock_guard<std::mutex> lock(_mx);
-    if (_publishers.count(key)) return;
-    auto pub = std::make_shared<Publisher>(_session.declare_publisher(make_keyexpr(key)));
-    _publishers.emplace(key, std::move(pub));
+    auto it = _publishers.find(key);
+    if (it != _publishers.end()) return it->second;
+    std::shared_ptr<PublisherHandle> pub(
+        new PublisherHandle(key, _session->declare_publisher(make_keyexpr(key)),
+                            add_stats_locked(EndpointKind::Publisher, key), _shm, opts));
+    if (pub->_delta) {
+        // Subscribers that lost a sample ask here; the next payload then goes out whole
+        pub->_keyframe_server = std::make_shared<Queryable<void>>(_session->declare_queryable(
+            make_keyexpr(key + kKeyframeSuffix),
+            [delta = pub->_delta, stats = pub->_stats](const Query&) {
+                delta->keyframe_requested.store(true, std::memory_order_relaxed);
+                stats->keyframe_requests.fetch_add(1, std::memory_order_relaxed);
+            },
+            closures::none));
+    }
+    if (pub->_retained) {
+        pub->_last_value_server = std::make_shared<Queryable<void>>(_session->declare_queryable(
+            make_keyexpr(key + kLastValueSuffix),
+            [retained = pub->_retained, stats = pub->_stats, reply_key = key + kLastValueSuffix](const Query& q) {
+                zenoh::Bytes payload;
+                Query::ReplyOptions opts;
+                {
+                    std::lock_guard<std::mutex> lk(retained->mx);
+                    if (!retained->set) return;  // nothing published yet: no reply
+                    payload = zenoh::Bytes(retained->payload.data(), retained->payload.size());
+                    opts.attachment = encode_header(retained->header);
+                }
+                try {
+                    q.reply(make_keyexpr(reply_key), std::move(payload), std::move(opts));
+                    stats->cache_hits.fetch_add(1, std::memory_order_relaxed);
+                } catch (...) {
+                    stats->errors.fetch_add(1, std::memory_order_relaxed);
+                }
+            },
+            closures::none));
+    }
+    _publishers.emplace(key, pub);
+    return pub;
 }
 
+// The returned handle keeps the publisher alive even if remove_publisher races with us
 void Node::publish(const std::string& key, const std::vector<uint8_t>& data) {
-    Publisher* pub = nullptr;
-    if (!has_publisher(key)) {
-        create_publisher(key);        
+    declare_publisher(key)->publish(data);
+}
+
+void Node::publish(const std::string& key, std::vector<uint8_t>&& data) {
+    declare_publisher(key)->publish(std::move(data));
+}
+
+void Node::publish(const std::string& key, const uint8_t* data, size_t len) {
+    declare_publisher(key)->publish(data, len);
+}
+
+void Node::publish_borrowed(const std::string& key, const uint8_t* data, size_t len,
+                            ReleaseCallback release) {
+    std::shared_ptr<PublisherHandle> pub;
+    try {
+        pub = declare_publisher(key);
+    } catch (...) {
+        if (release) release(data);  // keep the exactly-once promise
+        throw;
     }
-    auto it = _publishers.find(key);
-    it->second->put(zenoh::Bytes(data));
+    pub->publish_borrowed(data, len, std::move(release));
 }
 
 void Node::remove_publisher(const std::string& key) {
     std::lock_guard<std::mutex> lock(_mx);
     auto it = _publishers.find(key);
     if (it != _publishers.end()) {
-        it->second.reset();  // ensure undeclare before erase
+        it->second.reset();  // undeclares unless a PublisherHandle is still held elsewhere
         _publishers.erase(it);
     }
+    _stats.erase({EndpointKind::Publisher, key});
+}
+
+QuerierHandle::QuerierHandle(std::string key, std::chrono::milliseconds timeout, bool streaming,
+                             Querier&& querier, std::shared_ptr<EndpointStats> stats)
+    : _key(std::move(key)), _timeout(timeout), _streaming(streaming), _querier(std::move(querier)),
+      _stats(std::move(stats)) {}
+
+void QuerierHandle::get(const std::string& params, const uint8_t* data, size_t len,
+                        ReplyCallback on_reply, DoneCallback on_done) const {
+    // Per-get state shared by the two zenoh closures; nothing here refers back to the Node,
+    // so gets still in flight when the querier is removed finish normally.
+    struct GetState {
+        ReplyCallback on_reply;
+        DoneCallback on_done;
+        std::shared_ptr<EndpointStats> stats;
+        std::chrono::steady_clock::time_point started;
+        std::atomic<uint32_t> replies{0};
+    };
+    auto st = std::make_shared<GetState>();
+    st->on_reply = std::move(on_reply);
+    st->on_done = std::move(on_done);
+    st->stats = _stats;
+    st->started = std::chrono::steady_clock::now();
+
+    Querier::GetOptions opts;
+    if (data) opts.payload = zenoh::Bytes(data, len);
+    try {
+        _querier.get(params,
+            [st](const Reply& r) {
+                st->replies.fetch_add(1, std::memory_order_relaxed);
+                const bool ok = r.is_ok();
+                if (!ok) st->stats->errors.fetch_add(1, std::memory_order_relaxed);
+                if (!st->on_reply) return;
+                const std::string rkey = ok ? std::string(r.get_ok().get_keyexpr().as_string_view()) : std::string();
+                const Bytes& payload = ok ? r.get_ok().get_payload() : r.get_err().get_payload();
+                with_payload_view(payload, [&](BytesView v) {
+                    try {
+                        st->on_reply(ok, rkey, v);
+                    } catch (...) {
+                        st->stats->errors.fetch_add(1, std::memory_order_relaxed);
+                    }
+                });
+            },
+            [st]() {
+                if (st->replies.load(std::memory_order_relaxed) == 0)
+                    st->stats->timeouts.fetch_add(1, std::memory_order_relaxed);
+                st->stats->latency.record(std::chrono::steady_clock::now() - st->started);
+                if (st->on_done) {
+                    try { st->on_done(); } catch (...) { }
+                }
+            },
+            std::move(opts));
+    } catch (...) {
+        _stats->errors.fetch_add(1, std::memory_order_relaxed);
+        throw;
+    }
+    _stats->count(data ? len : 0);
+}
+
+std::future<std::vector<QueryReply>> QuerierHandle::get(const std::string& params,
+                                                        const uint8_t* data, size_t len) const {
+    struct Collected {
+        std::mutex mx;
+        std::vector<QueryReply> replies;
+        std::promise<std::vector<QueryReply>> done;
+    };
+    auto c = std::make_shared<Collected>();
+    auto fut = c->done.get_future();
+    get(params, data, len,
+        [c](bool ok, const std::string& key, BytesView payload) {
+            std::lock_guard<std::mutex> lk(c->mx);
+            c->replies.push_back(QueryReply{ok, key, payload.to_vector()});
+        },
+        [c]() {
+            std::lock_guard<std::mutex> lk(c->mx);
+            c->done.set_value(std::move(c->replies));
+        });
+    return fut;
+}
+
+std::shared_ptr<ReplyStream> QuerierHandle::get_stream(const std::string& params,
+                                                       const uint8_t* data, size_t len) const {
+    auto stream = std::make_shared<ReplyStream>();
+    get(params, data, len,
+        [stream](bool ok, const std::string& key, BytesView payload) {
+            stream->push(QueryReply{ok, key, payload.to_vector()});
+        },
+        [stream]() { stream->finish(); });
+    return stream;
+}
+
+void ReplyStream::push(QueryReply&& reply) {
+    {
+        std::lock_guard<std::mutex> lk(_mx);
+        _replies.push_back(std::move(reply));
+    }
+    _cv.notify_one();
+}
+
+void ReplyStream::finish() {
+    {
+        std::lock_guard<std::mutex> lk(_mx);
+        _finished = true;
+    }
+    _cv.notify_all();
+}
+
+bool ReplyStream::next(QueryReply& out) {
+    std::unique_lock<std::mutex> lk(_mx);
+    _cv.wait(lk, [&] { return _finished || !_replies.empty(); });
+    if (_replies.empty()) return false;
+    out = std::move(_replies.front());
+    _replies.pop_front();
+    return true;
+}
+
+bool ReplyStream::next(QueryReply& out, std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lk(_mx);
+    if (!_cv.wait_for(lk, timeout, [&] { return _finished || !_replies.empty(); })) return false;
+    if (_replies.empty()) return false;
+    out = std::move(_replies.front());
+    _replies.pop_front();
+    return true;
+}
+
+bool ReplyStream::done() const {
+    std::lock_guard<std::mutex> lk(_mx);
+    return _finished && _replies.empty();
+}
+
+size_t ReplyStream::buffered() const {
+    std::lock_guard<std::mutex> lk(_mx);
+    return _replies.size();
+}
+
+std::shared_ptr<QuerierHandle> Node::declare_querier(const std::string& key,
+                                                     std::chrono::milliseconds timeout, bool streaming) {
+    std::lock_guard<std::mutex> lock(_mx);
+    auto& queriers = streaming ? _stream_queriers : _queriers;
+    auto it = queriers.find(key);
+    if (it != queriers.end()) return it->second;
+
+    Session::QuerierOptions opts;
+    opts.timeout_ms = static_cast<uint64_t>(timeout.count());
+    // The default consolidation may hold replies back until the get ends and keeps only one
+    // per key, which would collapse a stream
+    if (streaming) opts.consolidation.mode = Z_CONSOLIDATION_MODE_NONE;
+    // Both queriers of a key count into the same stats entry
+    auto st = _stats.find({EndpointKind::Querier, key});
+    auto stats = st != _stats.end() ? st->second : add_stats_locked(EndpointKind::Querier, key);
+    std::shared_ptr<QuerierHandle> q(
+        new QuerierHandle(key, timeout, streaming,
+                          _session->declare_querier(make_keyexpr(key), std::move(opts)), std::move(stats)));
+    queriers.emplace(key, q);
+    return q;
+}
+
+void Node::get(const std::string& key, const std::string& params, const uint8_t* data, size_t len,
+               ReplyCallback on_reply, DoneCallback on_done) {
+    declare_querier(key)->get(params, data, len, std::move(on_reply), std::move(on_done));
+}
+
+std::future<std::vector<QueryReply>> Node::get(const std::string& key, const std::string& params,
+                                               const uint8_t* data, size_t len) {
+    return declare_querier(key)->get(params, data, len);
+}
+
+std::shared_ptr<ReplyStream> Node::get_stream(const std::string& key, const std::string& params,
+                                              const uint8_t* data, size_t len) {
+    return declare_querier(key, std::chrono::milliseconds(3000), true)->get_stream(params, data, len);
+}
+
+void Node::remove_querier(const std::string& key) {
+    std::lock_guard<std::mutex> lock(_mx);
+    _queriers.erase(key);  // undeclares unless a QuerierHandle is still held elsewhere
+    _stream_queriers.erase(key);
+    _stats.erase({EndpointKind::Querier, key});
 }
 
 bool Node::has_subscriber(const std::string& key) const {
@@ -114,33 +1335,356 @@ bool Node::has_subscriber(const std::string& key) const {
     return _subscribers.find(key) != _subscribers.end();
 }
 
-void Node::create_subscriber(const std::string& key, MessageCallback cb) {
-    std::lock_guard<std::mutex> lock(_mx);
-    if (_subscribers.count(key)) return;
+void Node::create_subscriber(const std::string& key, MessageCallback cb, const SubscriberOptions& opts) {
+    create_view_subscriber(key, [cb = std::move(cb)](const std::string& k, BytesView payload) {
+        cb(k, payload.to_vector());
+    }, opts);
+}
+
+bool Node::create_view_subscriber(const std::string& key, MessageViewCallback cb, const SubscriberOptions& opts) {
+    return create_keyed_subscriber(key, [cb = std::move(cb)](const InternedKey& k, BytesView payload) {
+        cb(k.name, payload);
+    }, opts);
+}
+
+bool Node::create_keyed_subscriber(const std::string& key, KeyedViewCallback cb, const SubscriberOptions& opts) {
+    if (_options.dispatch_threads > 0)
+        return dispatched_subscribe(key, std::move(cb), _options.dispatch, opts) != nullptr;
+    return subscribe(key, [cb = std::move(cb)](const InternedKey& k, BytesView payload) {
+        cb(k, payload);
+        return true;
+    }, opts);
+}
+
+bool Node::subscribe(const std::string& key, SampleSink sink, const SubscriberOptions& opts) {
+    std::unique_lock<std::mutex> lock(_mx);
+    if (_subscribers.count(key)) return false;
+    auto stats = add_stats_locked(EndpointKind::Subscriber, key);
+    const InternedKey* declared = KeyTable::global().intern(key);
+    if (!_blobs) _blobs = std::make_shared<BlobPool>(_options.reassembly.pool_buffers,
+                                                     _options.reassembly.prealloc_bytes);
+    auto fragments = std::make_shared<Reassembler>(_options.reassembly, _blobs);
+    {
+        std::lock_guard<std::mutex> lk(_requests->mx);
+        auto& sweeps = _requests->sweeps;
+        sweeps.erase(std::remove_if(sweeps.begin(), sweeps.end(),
+                                    [](const RequestTable::Sweep& w) { return w.fragments.expired(); }),
+                     sweeps.end());
+        sweeps.push_back(RequestTable::Sweep{fragments, stats});
+        _requests->stop = false;
+        if (!_timer.joinable()) _timer = std::thread([this] { timer_loop(); });
+    }
+    auto deltas = std::make_shared<DeltaDecoder>(opts.max_sources);
+    auto sequences = std::make_shared<SequenceTracker>(opts.max_sources);
+    auto replay = opts.fetch_last_value ? std::make_shared<ReplayFilter>() : nullptr;
 
-    // We extract as string (which is binary-safe in C++) and hand off a byte vector.
     auto sub = std::make_shared<Subscriber<void>>(
-        _session.declare_subscriber(
+        _session->declare_subscriber(
             make_keyexpr(key),
-            [cb, key](const Sample& s) {
-                const std::string bin = s.get_payload().as_string();   // preserves embedded '\0'
-                std::vector<uint8_t> bytes(bin.begin(), bin.end());
-                cb(key, bytes);
+            [sink, declared, stats, fragments, deltas, sequences, replay, blobs = _blobs,
+             session = std::weak_ptr<Session>(_session),
+             max_size = _options.reassembly.max_payload_bytes](const Sample& s) {
+                const auto t0 = std::chrono::steady_clock::now();
+                // Wildcard subscriptions report the concrete key of each sample; once a key
+                // has been seen, looking it up again allocates nothing
+                const std::string_view sample_key = s.get_keyexpr().as_string_view();
+                const InternedKey* interned = (declared && declared->name == sample_key)
+                    ? declared : KeyTable::global().intern(sample_key);
+                InternedKey uninterned;  // only when the table is full
+                if (!interned) uninterned.name.assign(sample_key.data(), sample_key.size());
+                const InternedKey& k = interned ? *interned : uninterned;
+                auto deliver = [&](BytesView payload) { run_sink(sink, *stats, k, payload); };
+                // Fragments are copied into a pooled buffer and compressed payloads inflated into
+                // another, then deltas applied to the publisher's last payload; the sink sees the
+                // whole payload once
+                SampleHeader h;
+                read_sample_header(s, h);
+                bool request_keyframe = false;
+                auto expand = [&](BytesView payload) {
+                    if (!h.delta) return deliver(payload);
+                    switch (deltas->apply(*h.delta, payload, deliver)) {
+                    case DeltaDecoder::Outcome::Delivered:
+                        if (h.delta->keyframe) stats->keyframes.fetch_add(1, std::memory_order_relaxed);
+                        else stats->count_delta(h.delta->size, payload.size);
+                        break;
+                    case DeltaDecoder::Outcome::Stale:
+                        break;
+                    case DeltaDecoder::Outcome::RequestKeyframe:
+                        request_keyframe = true;
+                        [[fallthrough]];
+                    case DeltaDecoder::Outcome::Missing:
+                        stats->dropped.fetch_add(1, std::memory_order_relaxed);
+                        break;
+                    }
+                };
+                auto decode = [&](BytesView payload) {
+                    if (!h.stamp) return expand(payload);
+                    // Once per whole payload, delivered or not
+                    const auto now = std::chrono::system_clock::now().time_since_epoch();
+                    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+                    // A source clock ahead of ours says nothing about latency: skipped
+                    if (ns >= 0 && static_cast<uint64_t>(ns) >= h.stamp->time_ns)
+                        stats->transit.record(static_cast<uint64_t>(ns) - h.stamp->time_ns);
+                    const auto seq = sequences->observe(h.stamp->source, h.stamp->seq);
+                    if (seq.missing) stats->gaps.fetch_add(seq.missing, std::memory_order_relaxed);
+                    if (seq.recovered) stats->gaps.fetch_sub(1, std::memory_order_relaxed);
+                    if (seq.reordered) stats->reordered.fetch_add(1, std::memory_order_relaxed);
+                    if (replay) replay->live(h.stamp->source, h.stamp->seq, [&] { expand(payload); });
+                    else expand(payload);
+                };
+                auto unpack = [&](BytesView payload) {
+                    if (!h.compression) return decode(payload);
+                    if (!with_inflated(*blobs, *h.compression, payload, max_size, *stats, decode))
+                        stats->errors.fetch_add(1, std::memory_order_relaxed);
+                };
+                if (h.fragment) {
+                    with_payload_view(s.get_payload(), [&](BytesView part) {
+                        if (size_t lost = fragments->add(*h.fragment, part, unpack))
+                            stats->dropped.fetch_add(lost, std::memory_order_relaxed);
+                    });
+                } else {
+                    with_payload_view(s.get_payload(), unpack);
+                }
+                // Outside the decoder's lock: a local publisher may answer synchronously
+                if (request_keyframe) {
+                    if (auto sess = session.lock()) {
+                        try {
+                            std::string rkey(sample_key);
+                            sess->get(KeyExpr(rkey + kKeyframeSuffix), "", [](const Reply&) {}, closures::none,
+                                      Session::GetOptions::create_default());
+                            stats->keyframe_requests.fetch_add(1, std::memory_order_relaxed);
+                        } catch (...) {
+                            stats->errors.fetch_add(1, std::memory_order_relaxed);
+                        }
+                    }
+                }
+                stats->latency.record(std::chrono::steady_clock::now() - t0);
             },
             closures::none
         )
     );
-    _subscribers.emplace(key, std::move(sub));
+    _subscribers.emplace(key, sub);
+    lock.unlock();
+
+    // Subscribed first, so nothing published from here on is missed; the replay filter sorts
+    // out the overlap. Outside _mx: a local publisher answers synchronously.
+    if (replay) {
+        Session::GetOptions get_opts;
+        get_opts.target = Z_QUERY_TARGET_ALL;
+        // The default consolidation keeps one reply per key: every publisher's value is wanted
+        get_opts.consolidation.mode = Z_CONSOLIDATION_MODE_NONE;
+        // Zero would mean zenoh's own default and a negative count would wrap: both take ours
+        const auto timeout = opts.fetch_timeout.count() > 0 ? opts.fetch_timeout : SubscriberOptions().fetch_timeout;
+        get_opts.timeout_ms = static_cast<uint64_t>(timeout.count());
+        try {
+            _session->get(make_keyexpr(key + kLastValueSuffix), "",
+                [sink, stats, deltas, replay, alive = std::weak_ptr<Subscriber<void>>(sub)](const Reply& r) {
+                    if (!r.is_ok()) return;
+                    auto subscribed = alive.lock();
+                    if (!subscribed) return;  // removed meanwhile
+                    const Sample& s = r.get_ok();
+                    std::string_view sample_key = s.get_keyexpr().as_string_view();
+                    const std::string_view suffix(kLastValueSuffix);
+                    if (sample_key.size() <= suffix.size() ||
+                        sample_key.substr(sample_key.size() - suffix.size()) != suffix) return;
+                    sample_key.remove_suffix(suffix.size());
+                    const InternedKey* interned = KeyTable::global().intern(sample_key);
+                    InternedKey uninterned;
+                    if (!interned) uninterned.name.assign(sample_key.data(), sample_key.size());
+                    const InternedKey& k = interned ? *interned : uninterned;
+
+                    SampleHeader h;
+                    read_sample_header(s, h);
+                    auto deliver = [&](BytesView payload) { run_sink(sink, *stats, k, payload); };
+                    // In delta mode the value also becomes the base for the deltas that follow
+                    auto expand = [&](BytesView payload) {
+                        if (h.delta && h.delta->keyframe) deltas->apply(*h.delta, payload, deliver);
+                        else deliver(payload);
+                    };
+                    with_payload_view(s.get_payload(), [&](BytesView payload) {
+                        if (h.stamp) replay->fetched(h.stamp->source, h.stamp->seq, [&] { expand(payload); });
+                        else expand(payload);
+                    });
+                },
+                [replay]() { replay->fetch_done(); },
+                std::move(get_opts));
+        } catch (...) {
+            stats->errors.fetch_add(1, std::memory_order_relaxed);
+            replay->fetch_done();
+        }
+    }
+    return true;
+}
+
+bool PolledSubscription::push(BytesView payload) {
+    while (_producer.test_and_set(std::memory_order_acquire)) std::this_thread::yield();
+    const bool ok = _ring.push(payload.data, payload.size);
+    _producer.clear(std::memory_order_release);
+    if (!ok) _dropped.fetch_add(1, std::memory_order_relaxed);
+    return ok;
 }
 
+size_t PolledSubscription::poll(uint8_t* out, size_t out_cap, int32_t* offsets, size_t max_msgs,
+                                size_t* needed) {
+    std::lock_guard<std::mutex> lk(_consumer);
+    if (needed) *needed = 0;
+    size_t count = 0, used = 0;
+    const uint8_t* data;
+    size_t len;
+    offsets[0] = 0;
+    while (count < max_msgs && _ring.peek(data, len)) {
+        if (used + len > out_cap) {
+            if (count == 0 && needed) *needed = len;
+            break;
+        }
+        if (len) std::memcpy(out + used, data, len);
+        _ring.pop();
+        used += len;
+        offsets[++count] = static_cast<int32_t>(used);
+    }
+    return count;
+}
+
+std::shared_ptr<PolledSubscription> Node::create_polled_subscriber(const std::string& key,
+                                                                   size_t capacity_bytes,
+                                                                   const SubscriberOptions& opts) {
+    auto polled = std::make_shared<PolledSubscription>(capacity_bytes);
+    const bool created = subscribe(key, [polled](const InternedKey&, BytesView payload) {
+        return polled->push(payload);
+    }, opts);
+    return created ? polled : nullptr;
+}
+
+void LatestValue::write(BytesView payload) {
+    std::lock_guard<std::mutex> wl(_writer);
+    Slot& slot = _slots[_back];
+    const uint64_t n = _seq.load(std::memory_order_relaxed) + 1;
+    slot.data.assign(payload.begin(), payload.end());
+    slot.seq = n;
+    _back = _middle.exchange(static_cast<uint8_t>(_back | kFresh), std::memory_order_acq_rel) & ~kFresh;
+    _seq.store(n, std::memory_order_release);
+}
+
+// Swaps in the newest published slot, if there is one the readers have not taken yet
+const LatestValue::Slot& LatestValue::front_locked() const {
+    if (_middle.load(std::memory_order_acquire) & kFresh)
+        _front = _middle.exchange(static_cast<uint8_t>(_front), std::memory_order_acq_rel) & ~kFresh;
+    return _slots[_front];
+}
+
+bool LatestValue::read(std::vector<uint8_t>& buf, uint64_t* seq) const {
+    std::lock_guard<std::mutex> rl(_reader);
+    const Slot& slot = front_locked();
+    if (seq) *seq = slot.seq;
+    if (slot.seq == 0) return false;
+    buf.assign(slot.data.begin(), slot.data.end());
+    return true;
+}
+
+bool LatestValue::read(uint8_t* out, size_t out_cap, size_t& len, uint64_t* seq) const {
+    std::lock_guard<std::mutex> rl(_reader);
+    const Slot& slot = front_locked();
+    if (seq) *seq = slot.seq;
+    len = slot.data.size();
+    if (slot.seq == 0 || len > out_cap) return false;
+    if (len) std::memcpy(out, slot.data.data(), len);
+    return true;
+}
+
+std::shared_ptr<LatestValue> Node::create_latest_subscriber(const std::string& key,
+                                                            const SubscriberOptions& opts) {
+    auto latest = std::make_shared<LatestValue>();
+    const bool created = subscribe(key, [latest](const InternedKey&, BytesView payload) {
+        latest->write(payload);
+        return true;
+    }, opts);
+    if (!created) return nullptr;
+    std::lock_guard<std::mutex> lock(_mx);
+    _latest[key] = latest;
+    return latest;
+}
+
+std::shared_ptr<LatestValue> Node::latest_subscription(const std::string& key) const {
+    std::lock_guard<std::mutex> lock(_mx);
+    auto it = _latest.find(key);
+    return it == _latest.end() ? nullptr : it->second;
+}
+
+bool Node::get_latest(const std::string& key, std::vector<uint8_t>& buf, uint64_t* seq) const {
+    auto latest = latest_subscription(key);
+    if (!latest) {
+        if (seq) *seq = 0;
+        return false;
+    }
+    return latest->read(buf, seq);
+}
+
+std::shared_ptr<Dispatcher> Node::dispatcher() {
+    std::lock_guard<std::mutex> lock(_mx);
+    if (!_dispatcher) {
+        size_t threads = _options.dispatch_threads;
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        _dispatcher = std::make_shared<Dispatcher>(threads);
+    }
+    return _dispatcher;
+}
+
+std::shared_ptr<DispatchQueue> Node::create_dispatched_subscriber(const std::string& key, MessageViewCallback cb,
+                                                                  const DispatchOptions& opts,
+                                                                  const SubscriberOptions& sub_opts) {
+    return dispatched_subscribe(key, [cb = std::move(cb)](const InternedKey& k, BytesView payload) {
+        cb(k.name, payload);
+    }, opts, sub_opts);
+}
+
+std::shared_ptr<DispatchQueue> Node::dispatched_subscribe(const std::string& key, KeyedViewCallback cb,
+                                                          const DispatchOptions& opts,
+                                                          const SubscriberOptions& sub_opts) {
+    auto queue = dispatcher()->make_queue(key, std::move(cb), opts);
+    const bool created = subscribe(key, [queue](const InternedKey& k, BytesView payload) {
+        return queue->push(k, payload);
+    }, sub_opts);
+    if (!created) return nullptr;
+
+    std::lock_guard<std::mutex> lock(_mx);
+    _dispatch_queues[key] = queue;
+    return queue;
+}
+
+std::shared_ptr<DispatchQueue> Node::dispatch_queue(const std::string& key) const {
+    std::lock_guard<std::mutex> lock(_mx);
+    auto it = _dispatch_queues.find(key);
+    return it != _dispatch_queues.end() ? it->second : nullptr;
+}
 
 void Node::remove_subscriber(const std::string& key) {
     std::lock_guard<std::mutex> lock(_mx);
+    auto dq = _dispatch_queues.find(key);
+    if (dq != _dispatch_queues.end()) {
+        dq->second->close();  // a producer blocked on it would otherwise stall the undeclare
+        _dispatch_queues.erase(dq);
+    }
     auto it = _subscribers.find(key);
     if (it != _subscribers.end()) {
         it->second.reset();
         _subscribers.erase(it);
     }
+    _latest.erase(key);
+    _stats.erase({EndpointKind::Subscriber, key});
+}
+
+std::shared_ptr<EndpointStats> Node::add_stats_locked(EndpointKind kind, const std::string& key) {
+    auto st = std::make_shared<EndpointStats>(key, kind);
+    _stats[{kind, key}] = st;
+    return st;
+}
+
+std::vector<EndpointStatsSnapshot> Node::stats() const {
+    std::lock_guard<std::mutex> lock(_mx);
+    std::vector<EndpointStatsSnapshot> out;
+    out.reserve(_stats.size());
+    for (auto& kv : _stats) out.push_back(kv.second->snapshot());
+    return out;
 }
 
 } // namespace ubicoders_zenoh
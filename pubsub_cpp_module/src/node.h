@@ -1,28 +1,445 @@
 #pragma once
 #include "zenoh.hxx"
+#include "spsc_ring.h"
+#include "stats.h"
+#include "bytes_view.h"
+#include "dispatcher.h"
+#include "server_pool.h"
+#include "reply_cache.h"
+#include "fragment.h"
+#include "delta.h"
+#include "sequence.h"
 
 #include <string>
+#include <map>
 #include <unordered_map>
 #include <functional>
 #include <mutex>
 #include <memory>
 #include <vector>
+#include <atomic>
+#include <optional>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <deque>
+#include <queue>
+#include <thread>
+#include <variant>
+
+// Shared-memory transport needs zenoh-c built with the shared-memory and unstable features
+#if defined(Z_FEATURE_SHARED_MEMORY) && defined(Z_FEATURE_UNSTABLE_API)
+#define ZNODE_HAS_SHM 1
+#else
+#define ZNODE_HAS_SHM 0
+#endif
 
 namespace ubicoders_zenoh {
 
+// Canned session setups, applied on top of the base config. All but Default skip the
+// scouting delay, so opening the session does not wait on discovery.
+enum class SessionPreset {
+    Default = 0,       // zenoh defaults: multicast scouting on the LAN
+    Loopback = 1,      // this host only: listen on 127.0.0.1, reach peers/router through `connect`
+                       // (default tcp/127.0.0.1:7447), gossip but no multicast scouting
+    FixedConnect = 2,  // only the `connect` endpoints (required), no scouting of any kind
+    NoScouting = 3,    // no multicast or gossip scouting; `listen` / `connect` as given
+};
+
+// Session settings for a Node. The defaults open the plain network session.
+struct NodeOptions {
+    // Base zenoh config: a JSON5 file, else inline JSON5, else Config::create_default().
+    // `preset` and the endpoint lists then override it. An unreadable config throws.
+    std::string config_file;
+    std::string config_json;
+    SessionPreset preset = SessionPreset::Default;
+    std::vector<std::string> connect;  // e.g. "tcp/192.168.1.10:7447"
+    std::vector<std::string> listen;   // e.g. "tcp/0.0.0.0:7447"
+    // Nodes whose session settings above (and shared_memory) match share one reference-counted
+    // zenoh session: one set of runtime threads, sockets and discovery per process. Endpoint
+    // tables, stats and lifetimes stay per node. false opens a private session.
+    bool share_session = true;
+
+    // Same-host peers exchange payloads through a POSIX shared-memory pool instead of the
+    // socket stack. Falls back to the network session when the zenoh build lacks SHM.
+    bool shared_memory = false;
+    size_t shm_pool_bytes = size_t(64) << 20;
+    // Payloads smaller than this are still sent inline; SHM only pays off for bulk data
+    size_t shm_threshold = 4096;
+
+    // Dispatch executor: > 0 runs create_subscriber / create_view_subscriber callbacks on this
+    // many workers instead of zenoh's RX threads, each key through a queue set by `dispatch`.
+    size_t dispatch_threads = 0;
+    DispatchOptions dispatch;
+
+    // Threads of the query pool behind ServerExecution::Shared servers (started on first
+    // use; 0 selects the hardware concurrency).
+    size_t query_threads = 0;
+
+    // How subscribers rebuild payloads sent by fragmenting publishers
+    ReassemblyOptions reassembly;
+};
+
+// Per-publisher settings, fixed when the publisher is declared
+struct PublisherOptions {
+    // > 0: payloads larger than this go out as fragments of this size, one sample each, and
+    // every subscriber of the node API reassembles them into a pooled buffer before its
+    // callback runs. No allocation on either side grows with the payload. Fragmented
+    // payloads bypass the shared-memory pool.
+    size_t fragment_bytes = 0;
+    // Compresses payloads before they are sent (and fragmented); subscribers of the node API
+    // decompress them transparently into a pooled buffer. Loaned shared-memory buffers are
+    // always sent as they are.
+    CompressionOptions compression;
+    // Sends deltas against the previous payload between periodic keyframes; subscribers of the
+    // node API rebuild full payloads and, after a gap, ask the publisher for a keyframe
+    // through a queryable it declares at `<key>/@keyframe`. Deltas are compressed and
+    // fragmented like any payload. Publishing through the handle is serialized in this mode.
+    DeltaOptions delta;
+    // Tags each payload with a sequence number and the publisher's system-clock time.
+    // Subscribers of the node API then track one-way latency (as good as the clock sync
+    // between the hosts), gaps and reordering in their stats.
+    bool stamp = false;
+    // Keeps the last payload and serves it to late joiners (see
+    // SubscriberOptions::fetch_last_value) through a queryable at `<key>/@last`. Implies
+    // `stamp`, which subscribers use to merge it with the live stream.
+    bool last_value_cache = false;
+};
+
+struct SubscriberOptions {
+    // Right after subscribing, fetches the last value of every publisher on the key that keeps
+    // one (PublisherOptions::last_value_cache) and delivers it like a live sample. A value
+    // the live stream has already delivered, or outrun, is skipped.
+    bool fetch_last_value = false;
+    std::chrono::milliseconds fetch_timeout{1000};  // <= 0 selects 1000
+    // Publishers on the key tracked at once, each for its delta stream and its sequence
+    // numbers. Past that, the one heard from least recently is forgotten: it needs a keyframe
+    // before its deltas decode again, and what it lost meanwhile is not counted in gaps.
+    size_t max_sources = 16;
+};
+
+// Called once zenoh no longer needs a borrowed buffer (may run on a zenoh thread).
+using ReleaseCallback = std::function<void(const uint8_t* data)>;
+
+class ShmPool;
+
+// Writable payload buffer from PublisherHandle::loan. Backed by the node's shared-memory
+// pool when it has one, so the caller fills it in place and publish() sends it without
+// copying; otherwise plain heap memory. Move-only, published at most once.
+class LoanedBuffer {
+public:
+    LoanedBuffer(LoanedBuffer&&) = default;
+    LoanedBuffer& operator=(LoanedBuffer&&) = default;
+
+    uint8_t* data();
+    size_t size() const;
+    bool shared_memory() const;
+
+private:
+    friend class PublisherHandle;
+    explicit LoanedBuffer(std::vector<uint8_t>&& heap) : _buf(std::move(heap)) {}
+#if ZNODE_HAS_SHM
+    explicit LoanedBuffer(zenoh::ZShmMut&& shm) : _buf(std::move(shm)) {}
+    std::variant<std::vector<uint8_t>, zenoh::ZShmMut> _buf;
+#else
+    std::variant<std::vector<uint8_t>> _buf;
+#endif
+};
+
+// Pre-resolved publisher returned by Node::declare_publisher. Publishing through it
+// skips the key lookup and the node mutex. Safe to share across threads; the zenoh
+// publisher stays declared while any handle to it is alive.
+class PublisherHandle {
+public:
+    PublisherHandle(const PublisherHandle&) = delete;
+    PublisherHandle& operator=(const PublisherHandle&) = delete;
+
+    const std::string& key() const { return _key; }
+    EndpointStatsSnapshot stats() const { return _stats->snapshot(); }
+
+    void publish(const std::vector<uint8_t>& data) const;  // one copy
+    void publish(std::vector<uint8_t>&& data) const;       // no copy, takes ownership
+    void publish(const uint8_t* data, size_t len) const;   // one copy
+    void publish_borrowed(const uint8_t* data, size_t len, ReleaseCallback release) const;
+
+    // Zero-copy publishing of large payloads: fill the loaned buffer, then publish it.
+    LoanedBuffer loan(size_t len) const;
+    void publish(LoanedBuffer&& buf) const;
+
+private:
+    friend class Node;
+    PublisherHandle(std::string key, zenoh::Publisher&& pub, std::shared_ptr<EndpointStats> stats,
+                    std::shared_ptr<ShmPool> shm, const PublisherOptions& opts);
+    void put(zenoh::Bytes&& payload, const SampleHeader& header = SampleHeader()) const;
+    // False: too small or pool exhausted
+    bool put_shm(const uint8_t* data, size_t len, const SampleHeader& header = SampleHeader()) const;
+    SampleHeader stamped() const;  // with a StampHeader when stamping, otherwise empty
+    bool fragmented(size_t len) const { return _fragment_bytes && len > _fragment_bytes; }
+    // Sends [data, data + len) as fragments; `keep` (may be null) holds the bytes alive until
+    // zenoh releases the last fragment, otherwise each fragment is copied. Every fragment
+    // also carries `header`'s other records.
+    void put_fragments(const uint8_t* data, size_t len, std::shared_ptr<const void> keep,
+                       SampleHeader header = SampleHeader()) const;
+    // Sends a compressed copy instead when the codec applies and the payload compresses well
+    // enough; false means the caller still has to send it
+    bool put_compressed(const uint8_t* data, size_t len, SampleHeader header = SampleHeader()) const;
+    // Copies [data, data + len) out tagged with `header`: compressed, fragmented or as it is
+    void put_tagged(const uint8_t* data, size_t len, const SampleHeader& header) const;
+    // Sends the payload as a keyframe or a delta; false when delta mode is off
+    bool put_delta(const uint8_t* data, size_t len) const;
+
+    // Last-value cache: copies the payload and its stamp for the queryable to serve (delta
+    // mode, after its put)
+    void retain(const uint8_t* data, size_t len, const SampleHeader& header) const;
+
+    // Stamps one publish outside delta mode. With the last-value cache on, it also keeps
+    // publishes in stamp order and, once the publish returns without throwing, retains the
+    // payload it copied up front (the caller's buffer may be gone by then).
+    class Publishing {
+    public:
+        Publishing(const PublisherHandle& pub, const uint8_t* data, size_t len);
+        ~Publishing();
+        Publishing(const Publishing&) = delete;
+        Publishing& operator=(const Publishing&) = delete;
+        const SampleHeader& header() const { return _header; }
+
+    private:
+        const PublisherHandle& _pub;
+        std::unique_lock<std::mutex> _order;
+        SampleHeader _header;
+        const int _exceptions;
+    };
+
+    // Delta mode: the previous payload, which deltas are taken against
+    struct DeltaState {
+        std::mutex mx;  // serializes publishing, so sequence numbers follow wire order
+        std::vector<uint8_t> prev;
+        std::vector<uint8_t> scratch;  // the encoded delta
+        uint32_t seq = 0;
+        uint32_t since_keyframe = 0;
+        bool started = false;
+        std::atomic<bool> keyframe_requested{false};  // set by the keyframe queryable
+    };
+
+    std::string _key;
+    zenoh::Publisher _pub;
+    std::shared_ptr<EndpointStats> _stats;
+    std::shared_ptr<ShmPool> _shm;  // null unless the node runs in shared-memory mode
+    size_t _fragment_bytes = 0;
+    uint64_t _source = 0;  // FragmentHeader, DeltaHeader and StampHeader::source
+    mutable std::atomic<uint32_t> _transfers{0};
+    CompressionOptions _compression;  // codec None when off or not compiled in
+    mutable std::atomic<uint32_t> _poor_run{0};  // payloads in a row that did not compress well
+    mutable std::atomic<uint32_t> _probe{0};
+    DeltaOptions _delta_opts;
+    std::shared_ptr<DeltaState> _delta;  // null unless delta mode is on
+    std::shared_ptr<zenoh::Queryable<void>> _keyframe_server;
+    bool _stamp = false;
+    mutable std::atomic<uint64_t> _stamps{0};  // StampHeader::seq
+
+    struct Retained {
+        std::mutex order;              // held by Publishing from stamp to retain
+        std::vector<uint8_t> staged;   // the payload in flight, guarded by `order`
+        std::mutex mx;
+        std::vector<uint8_t> payload;  // reused
+        SampleHeader header;           // stamp, plus a keyframe record in delta mode
+        bool set = false;
+    };
+    std::shared_ptr<Retained> _retained;  // null unless last_value_cache is on
+    std::shared_ptr<zenoh::Queryable<void>> _last_value_server;
+};
+
+// Subscription whose samples are queued natively in a bounded ring instead of being
+// handed to a callback; the owner drains it from its own thread (e.g. once per frame).
+// Samples that do not fit are dropped and counted.
+class PolledSubscription {
+public:
+    explicit PolledSubscription(size_t capacity_bytes) : _ring(capacity_bytes) {}
+    PolledSubscription(const PolledSubscription&) = delete;
+    PolledSubscription& operator=(const PolledSubscription&) = delete;
+
+    // Copies up to `max_msgs` queued messages back to back into `out` (at most `out_cap`
+    // bytes). Message i spans [offsets[i], offsets[i + 1]), so `offsets` needs max_msgs + 1
+    // entries. Returns the number of messages copied. If the oldest message alone does not
+    // fit, nothing is consumed and its size is stored in `*needed`.
+    size_t poll(uint8_t* out, size_t out_cap, int32_t* offsets, size_t max_msgs,
+                size_t* needed = nullptr);
+
+    uint64_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+private:
+    friend class Node;
+    bool push(BytesView payload);  // producer: zenoh RX threads; false if dropped
+
+    SpscByteRing _ring;
+    std::atomic_flag _producer = ATOMIC_FLAG_INIT;  // zenoh may deliver from several threads
+    std::mutex _consumer;                           // keeps poll() single-consumer
+    std::atomic<uint64_t> _dropped{0};
+};
+
+// Conflating slot holding only the newest sample of a subscription. Triple-buffered: the
+// writer fills a buffer of its own and publishes it with one atomic exchange, so it never
+// waits on a reader; readers take the newest published buffer the same way and copy out of
+// it, waiting only on each other. Buffers are reused, so a steady-size stream stops
+// allocating after the first samples.
+class LatestValue {
+public:
+    LatestValue() = default;
+    LatestValue(const LatestValue&) = delete;
+    LatestValue& operator=(const LatestValue&) = delete;
+
+    // Copies the newest payload into `buf`. Returns false if nothing has arrived yet.
+    // `seq` (optional) receives the sample counter, which grows by one per received sample.
+    bool read(std::vector<uint8_t>& buf, uint64_t* seq = nullptr) const;
+    bool read(uint8_t* out, size_t out_cap, size_t& len, uint64_t* seq = nullptr) const;
+    uint64_t seq() const { return _seq.load(std::memory_order_acquire); }
+
+private:
+    friend class Node;
+    void write(BytesView payload);  // zenoh RX threads
+
+    struct Slot {
+        std::vector<uint8_t> data;
+        uint64_t seq = 0;  // 0: never written
+    };
+    static constexpr uint8_t kFresh = 4;  // in _middle: published since a reader last took it
+
+    const Slot& front_locked() const;
+
+    mutable Slot _slots[3];
+    int _back = 1;                             // the writer's slot, guarded by _writer
+    mutable std::atomic<uint8_t> _middle{2};   // the last published slot
+    mutable int _front = 0;                    // the readers' slot, guarded by _reader
+    std::atomic<uint64_t> _seq{0};
+    std::mutex _writer;          // serializes writers (zenoh may deliver from several threads)
+    mutable std::mutex _reader;  // serializes readers
+};
+
+// One reply collected by the future-returning QuerierHandle::get.
+struct QueryReply {
+    bool ok = false;               // false: error reply, `payload` holds the error message
+    std::string key;               // replying key (empty for error replies)
+    std::vector<uint8_t> payload;
+};
+
+// Replies of one get_stream, buffered as they arrive and consumed in order with next().
+// Safe to share across threads.
+class ReplyStream {
+public:
+    ReplyStream() = default;
+    ReplyStream(const ReplyStream&) = delete;
+    ReplyStream& operator=(const ReplyStream&) = delete;
+
+    // Blocks until the next reply is available (true) or the get is over (false)
+    bool next(QueryReply& out);
+    // Same, giving up after `timeout`; check done() to tell a timeout from the end
+    bool next(QueryReply& out, std::chrono::milliseconds timeout);
+    bool done() const;       // the get is over and every reply was consumed
+    size_t buffered() const;
+
+private:
+    friend class QuerierHandle;
+    void push(QueryReply&& reply);
+    void finish();
+
+    mutable std::mutex _mx;
+    std::condition_variable _cv;
+    std::deque<QueryReply> _replies;
+    bool _finished = false;
+};
+
+// Pre-declared querier returned by Node::declare_querier. Any number of gets can be in
+// flight on one querier at once; each completes independently through its own callbacks.
+// Safe to share across threads.
+class QuerierHandle {
+public:
+    // Runs on a zenoh thread for every reply. `payload` is only valid during the call.
+    using ReplyCallback = std::function<void(bool ok, const std::string& key, BytesView payload)>;
+    // Runs exactly once per get, after its last reply or once the timeout expired.
+    using DoneCallback = std::function<void()>;
+
+    QuerierHandle(const QuerierHandle&) = delete;
+    QuerierHandle& operator=(const QuerierHandle&) = delete;
+
+    const std::string& key() const { return _key; }
+    std::chrono::milliseconds timeout() const { return _timeout; }
+    // True when replies are delivered as they arrive, without consolidation (see
+    // Node::declare_querier); required to receive every reply of a streaming server.
+    bool streaming() const { return _streaming; }
+    EndpointStatsSnapshot stats() const { return _stats->snapshot(); }
+
+    // Sends one query; returns as soon as it is on the wire. `data` may be null (no payload).
+    void get(const std::string& params, const uint8_t* data, size_t len,
+             ReplyCallback on_reply, DoneCallback on_done = nullptr) const;
+    // Same, collecting every reply; the future is ready once the query is done.
+    std::future<std::vector<QueryReply>> get(const std::string& params = std::string(),
+                                             const uint8_t* data = nullptr, size_t len = 0) const;
+    // Same, handing out replies one by one while the query is still running. Replies the
+    // reader has not consumed yet are buffered; use the callback get to avoid buffering.
+    std::shared_ptr<ReplyStream> get_stream(const std::string& params = std::string(),
+                                            const uint8_t* data = nullptr, size_t len = 0) const;
+
+private:
+    friend class Node;
+    QuerierHandle(std::string key, std::chrono::milliseconds timeout, bool streaming,
+                  zenoh::Querier&& querier, std::shared_ptr<EndpointStats> stats);
+
+    std::string _key;
+    std::chrono::milliseconds _timeout;
+    bool _streaming;
+    zenoh::Querier _querier;
+    std::shared_ptr<EndpointStats> _stats;
+};
+
+// Reply side of one query to a streaming server. Each send() goes out as its own reply
+// right away, so a handler can emit chunks or rows while it is still computing. The query
+// ends on finish(), fail(), or when the last copy of the sink is dropped. Copies share the
+// stream and may be moved to other threads; sends are serialized.
+class ReplySink {
+public:
+    // False once the stream has ended (nothing is sent)
+    bool send(const uint8_t* data, size_t len);
+    bool send(BytesView payload) { return send(payload.data, payload.size); }
+    bool send(std::vector<uint8_t>&& data);  // no copy
+    // Sends an error reply and ends the stream
+    bool fail(const std::string& message);
+    void finish();
+
+    bool open() const;
+    uint32_t sent() const;  // replies sent so far
+
+private:
+    friend class Node;
+    struct State;
+    explicit ReplySink(std::shared_ptr<State> state) : _state(std::move(state)) {}
+    bool reply(zenoh::Bytes&& payload);
+
+    std::shared_ptr<State> _state;
+};
+
 class Node {
 public:
     // Callback now delivers raw bytes
     using MessageCallback = std::function<void(const std::string& key,
                                                const std::vector<uint8_t>& payload)>;
+    // Zero-copy delivery: views the zenoh payload directly when it is contiguous,
+    // otherwise a per-thread pooled buffer holding a single copy.
+    // `key` is the sample's concrete key, which differs from the declared one for wildcards.
+    using MessageViewCallback = std::function<void(const std::string& key, BytesView payload)>;
+    // Same, with the concrete key interned (see KeyTable): `key.id` is a small integer that is
+    // stable for the process, so wildcard consumers can index per-key state without hashing.
+    using KeyedViewCallback = std::function<void(const InternedKey& key, BytesView payload)>;
 
     explicit Node(const std::string& name);
+    Node(const std::string& name, const NodeOptions& options);
     Node();
     Node(const Node&) = delete;
     Node& operator=(const Node&) = delete;
     ~Node();
 
     const std::string& name() const { return _name; }  // NEW
+    // True when payloads at or above the threshold travel through shared memory
+    bool shared_memory() const { return _shm != nullptr; }
 
     // ---- Query server (queryable) management ----
     // Synchronous handler: return the reply bytes for this query
@@ -31,37 +448,223 @@ public:
         const std::string& parameters,
         const std::vector<uint8_t>& payload)>;
 
+    // Same, but the query payload is delivered as a view (see MessageViewCallback)
+    using QueryViewHandler = std::function<std::vector<uint8_t>(
+        const std::string& key,
+        const std::string& parameters,
+        BytesView payload)>;
+
     // Declare a queryable "server" at `key`. Each incoming query calls `handler`,
-    // and we reply with its returned bytes.
-    void create_server(const std::string& key, QueryHandler handler);
+    // and we reply with its returned bytes. `opts` picks where the handler runs; the pooled
+    // modes bound concurrency and queueing and answer excess queries at once with
+    // reply_err(opts.overload_reply), counted as dropped in stats().
+    void create_server(const std::string& key, QueryHandler handler,
+                       const ServerOptions& opts = ServerOptions());
+    void create_view_server(const std::string& key, QueryViewHandler handler,
+                            const ServerOptions& opts = ServerOptions());
+
+    // Streaming handler: sends any number of replies through `sink` (see ReplySink). The
+    // query ends when the handler returns, unless it kept a copy of the sink.
+    using StreamingQueryHandler = std::function<void(
+        const std::string& key,
+        const std::string& parameters,
+        BytesView payload,
+        ReplySink sink)>;
+
+    // Declare a queryable that answers each query with a stream of replies. `opts` works as
+    // for create_server, except that opts.cache is ignored. Clients need a streaming querier
+    // (declare_querier(..., true) or get_stream) to see every reply as it arrives.
+    void create_streaming_server(const std::string& key, StreamingQueryHandler handler,
+                                 const ServerOptions& opts = ServerOptions());
+
+    // Deferred handler: must return right away. The query is parked in the node under
+    // `request_id` and answered later, from any thread, with complete_request / fail_request.
+    using DeferredQueryHandler = std::function<void(
+        uint64_t request_id,
+        const std::string& key,
+        const std::string& parameters,
+        BytesView payload)>;
+
+    // Declare a queryable whose replies are sent asynchronously. Queries not answered
+    // within `timeout` get an "error: timeout" reply from the node's single timer thread,
+    // so no zenoh thread ever blocks waiting for the handler's owner.
+    // `cache` works as ServerOptions::cache: hits are answered without calling `handler`.
+    void create_deferred_server(const std::string& key, DeferredQueryHandler handler,
+                                std::chrono::milliseconds timeout = std::chrono::milliseconds(3000),
+                                const ReplyCacheOptions& cache = ReplyCacheOptions());
+
+    // Answer a pending deferred query. Returns false if it already completed or timed out.
+    bool complete_request(uint64_t request_id, const uint8_t* data, size_t len);
+    bool fail_request(uint64_t request_id, const std::string& message);
+    // Streams a deferred reply: every reply_partial goes out as its own reply and the query
+    // stays pending; complete_request, fail_request or finish_request end it. `timeout`
+    // bounds the whole stream. Returns false if the query is gone, or if it belongs to a
+    // server with a reply cache (only single replies can be cached).
+    bool reply_partial(uint64_t request_id, const uint8_t* data, size_t len);
+    bool finish_request(uint64_t request_id);  // ends the stream without another reply
 
     // Undeclare a server for `key`.
     void remove_server(const std::string& key);
 
     // ---- Publisher management ----
+    using ReleaseCallback = ubicoders_zenoh::ReleaseCallback;
+
     bool has_publisher(const std::string& key) const;
-    void create_publisher(const std::string& key);
-    void publish(const std::string& key, const std::vector<uint8_t>& data);
+    void create_publisher(const std::string& key, const PublisherOptions& opts = PublisherOptions());
+    // Declares (or reuses) the publisher for `key` and returns it for lookup-free publishing.
+    // `opts` only applies when the publisher is created.
+    std::shared_ptr<PublisherHandle> declare_publisher(const std::string& key,
+                                                       const PublisherOptions& opts = PublisherOptions());
+    void publish(const std::string& key, const std::vector<uint8_t>& data);  // one copy
+    void publish(const std::string& key, std::vector<uint8_t>&& data);       // no copy, takes ownership
+    void publish(const std::string& key, const uint8_t* data, size_t len);   // one copy
+    // No copy: `data` must stay valid until `release` is called. `release` runs exactly once,
+    // also when the put fails.
+    void publish_borrowed(const std::string& key, const uint8_t* data, size_t len,
+                          ReleaseCallback release);
     void remove_publisher(const std::string& key);   // NEW
 
+    // ---- Query client (querier) management ----
+    using ReplyCallback = QuerierHandle::ReplyCallback;
+    using DoneCallback = QuerierHandle::DoneCallback;
+
+    // Declares (or reuses) the querier for `key`. `timeout` only applies when the querier
+    // is created; a querier that already exists keeps its own. A `streaming` querier turns
+    // off reply consolidation, so every reply is delivered as soon as it arrives; it is kept
+    // apart from the regular querier of the same key.
+    std::shared_ptr<QuerierHandle> declare_querier(const std::string& key,
+                                                   std::chrono::milliseconds timeout = std::chrono::milliseconds(3000),
+                                                   bool streaming = false);
+    // One-shot gets through the (lazily declared) querier for `key`; see QuerierHandle::get.
+    void get(const std::string& key, const std::string& params, const uint8_t* data, size_t len,
+             ReplyCallback on_reply, DoneCallback on_done = nullptr);
+    std::future<std::vector<QueryReply>> get(const std::string& key,
+                                             const std::string& params = std::string(),
+                                             const uint8_t* data = nullptr, size_t len = 0);
+    // Get through the streaming querier for `key`; see QuerierHandle::get_stream
+    std::shared_ptr<ReplyStream> get_stream(const std::string& key,
+                                            const std::string& params = std::string(),
+                                            const uint8_t* data = nullptr, size_t len = 0);
+    void remove_querier(const std::string& key);  // both the regular and the streaming one
+
     // ---- Subscriber management ----
     bool has_subscriber(const std::string& key) const;
-    void create_subscriber(const std::string& key, MessageCallback cb);
+    // Conflating: keeps only the newest sample for `key` instead of running a callback.
+    // Returns nullptr if `key` already has a subscriber.
+    std::shared_ptr<LatestValue> create_latest_subscriber(const std::string& key,
+                                                          const SubscriberOptions& opts = SubscriberOptions());
+    std::shared_ptr<LatestValue> latest_subscription(const std::string& key) const;
+    // Reads the newest sample of a latest-value subscription (see LatestValue::read).
+    bool get_latest(const std::string& key, std::vector<uint8_t>& buf, uint64_t* seq = nullptr) const;
+
+    // One copy per sample
+    void create_subscriber(const std::string& key, MessageCallback cb,
+                           const SubscriberOptions& opts = SubscriberOptions());
+    // False if `key` exists
+    bool create_view_subscriber(const std::string& key, MessageViewCallback cb,
+                                const SubscriberOptions& opts = SubscriberOptions());
+    bool create_keyed_subscriber(const std::string& key, KeyedViewCallback cb,
+                                 const SubscriberOptions& opts = SubscriberOptions());
+    // No callback: samples are queued in a native ring of `capacity_bytes` for poll().
+    // Returns nullptr if `key` already has a subscriber.
+    std::shared_ptr<PolledSubscription> create_polled_subscriber(const std::string& key,
+                                                                 size_t capacity_bytes = 1 << 20,
+                                                                 const SubscriberOptions& opts = SubscriberOptions());
+    // Callback runs on the node's dispatch executor (started on first use) rather than a zenoh
+    // RX thread: FIFO per key, keys in parallel, and a bounded queue applying `opts.overflow`
+    // when full. A slow callback then only backs up its own key. stats() latency covers the
+    // enqueue; the returned queue counts drops and throwing callbacks.
+    // Returns nullptr if `key` already has a subscriber.
+    std::shared_ptr<DispatchQueue> create_dispatched_subscriber(const std::string& key, MessageViewCallback cb,
+                                                                const DispatchOptions& opts = DispatchOptions(),
+                                                                const SubscriberOptions& sub_opts = SubscriberOptions());
+    std::shared_ptr<DispatchQueue> dispatch_queue(const std::string& key) const;
     void remove_subscriber(const std::string& key);  // NEW
 
+    // ---- Runtime statistics ----
+    // Snapshot of the per-key counters of every live publisher, subscriber and server.
+    // Counters are updated with relaxed atomics only; reading them takes the node mutex.
+    std::vector<EndpointStatsSnapshot> stats() const;
+
     void shutdown();
 
 private:
-    zenoh::Session _session;
+    std::shared_ptr<zenoh::Session> _session;  // possibly shared with other nodes (see share_session)
     std::string _name;  // NEW
+    NodeOptions _options;
+    std::shared_ptr<ShmPool> _shm;
+    std::shared_ptr<Dispatcher> _dispatcher;  // lazily started
+    std::shared_ptr<TaskPool> _query_pool;    // ServerExecution::Shared, lazily started
+    std::shared_ptr<BlobPool> _blobs;         // reassembly buffers of fragmented payloads
 
-    std::unordered_map<std::string, std::shared_ptr<zenoh::Publisher>>        _publishers;
+    std::unordered_map<std::string, std::shared_ptr<PublisherHandle>>         _publishers;
     std::unordered_map<std::string, std::shared_ptr<zenoh::Subscriber<void>>> _subscribers;
     std::unordered_map<std::string, std::shared_ptr<zenoh::Queryable<void>>>  _servers;
+    std::unordered_map<std::string, std::shared_ptr<ServerQueue>>             _server_queues;
+    std::unordered_map<std::string, std::shared_ptr<LatestValue>>             _latest;
+    std::unordered_map<std::string, std::shared_ptr<QuerierHandle>>           _queriers;
+    std::unordered_map<std::string, std::shared_ptr<QuerierHandle>>           _stream_queriers;
+    std::unordered_map<std::string, std::shared_ptr<DispatchQueue>>           _dispatch_queues;
+    std::map<std::pair<EndpointKind, std::string>, std::shared_ptr<EndpointStats>> _stats;
 
     mutable std::mutex _mx;
 
+    // ---- Deferred queries: pending table + one timer thread enforcing deadlines (and
+    // sweeping abandoned fragment transfers) ----
+    using Deadline = std::pair<std::chrono::steady_clock::time_point, uint64_t>;
+    struct PendingQuery {
+        zenoh::Query query;
+        std::string key;
+        std::chrono::steady_clock::time_point arrived;
+        std::shared_ptr<EndpointStats> stats;
+        std::shared_ptr<ReplyCache> cache;  // set when this query leads a cache miss
+        std::string cache_key;
+    };
+
+    // Shared with the queryable callbacks: on a shared session one can still be running after
+    // this node is gone, so they hold the table rather than the node
+    struct RequestTable {
+        std::unordered_map<uint64_t, PendingQuery> pending;
+        std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>> deadlines;
+        std::atomic<uint64_t> next_id{1};
+        std::mutex mx;
+        std::condition_variable timer_cv;
+        bool stop = false;
+        // Subscriptions' reassemblers, swept once per reassembly timeout while any is alive
+        struct Sweep {
+            std::weak_ptr<Reassembler> fragments;
+            std::weak_ptr<EndpointStats> stats;
+        };
+        std::vector<Sweep> sweeps;
+
+        std::optional<PendingQuery> take(uint64_t request_id);
+        bool fail(uint64_t request_id, const std::string& message);
+    };
+
+    const std::shared_ptr<RequestTable> _requests = std::make_shared<RequestTable>();
+    std::thread _timer;
+
+    // Subscription sink: returns false when it had to drop the sample (counted as dropped)
+    using SampleSink = std::function<bool(const InternedKey& key, BytesView payload)>;
+
     static zenoh::KeyExpr make_keyexpr(const std::string& key);
+    std::shared_ptr<EndpointStats> add_stats_locked(EndpointKind kind, const std::string& key);
+    bool subscribe(const std::string& key, SampleSink sink, const SubscriberOptions& opts = SubscriberOptions());
+    std::shared_ptr<Dispatcher> dispatcher();
+    std::shared_ptr<ServerQueue> make_server_queue_locked(const ServerOptions& opts);
+    // Runs one query of a server: replies, or replies with an error, and settles `cache_key`
+    // when the server has a cache. May run on a zenoh thread or a pool thread.
+    using ServeFn = std::function<void(const zenoh::Query& q, const std::string& params, BytesView payload,
+                                       const std::string& cache_key)>;
+    void declare_server_locked(const std::string& key, const ServerOptions& opts,
+                               std::shared_ptr<EndpointStats> stats, std::shared_ptr<ReplyCache> cache,
+                               ServeFn serve);
+    static bool cache_front(ReplyCache& cache, const zenoh::Query& q, const std::string& key, BytesView payload,
+                            EndpointStats& stats, std::string& cache_key);
+    std::shared_ptr<DispatchQueue> dispatched_subscribe(const std::string& key, KeyedViewCallback cb,
+                                                        const DispatchOptions& opts,
+                                                        const SubscriberOptions& sub_opts = SubscriberOptions());
+    void timer_loop();
 };
 
 } // namespace ubicoders_zenoh
@@ -7,8 +7,11 @@
 #include <iostream>
 #include <iomanip>
 
-int main() {
-    ZU_NodeHandle node = ZU_CreateNode("publisher_node");
+int main(int argc, char** argv) {
+    // --shm: exchange payloads with same-host peers through shared memory
+    ZU_NodeOptions options = {};
+    options.shared_memory = (argc > 1 && std::string(argv[1]) == "--shm") ? 1 : 0;
+    ZU_NodeHandle node = ZU_CreateNodeWithOptions("publisher_node", &options);
 
     const char* key = "demo/example/bytes";
     const std::vector<uint8_t> payload = {
@@ -0,0 +1,410 @@
+// recorder.cpp
+#include "recorder.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ubicoders_zenoh {
+
+namespace {
+
+// A whole file mapped into memory, either created at a fixed size for writing or opened
+// read-only. close(used) trims a written file down to the bytes actually used.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool create(const std::string& path, size_t size) { return map(path, size, true); }
+    bool open_read(const std::string& path) { return map(path, 0, false); }
+
+    uint8_t* data() const { return _data; }
+    size_t size() const { return _size; }
+    bool is_open() const { return _data != nullptr; }
+
+    void close(size_t used = SIZE_MAX) {
+        if (!_data) return;
+#ifdef _WIN32
+        UnmapViewOfFile(_data);
+        CloseHandle(_mapping);
+        if (_writable && used < _size) {
+            LARGE_INTEGER pos;
+            pos.QuadPart = static_cast<LONGLONG>(used);
+            SetFilePointerEx(_file, pos, nullptr, FILE_BEGIN);
+            SetEndOfFile(_file);
+        }
+        CloseHandle(_file);
+        _mapping = _file = nullptr;
+#else
+        munmap(_data, _size);
+        if (_writable && used < _size && ftruncate(_fd, static_cast<off_t>(used)) != 0) { /* keep the padding */ }
+        ::close(_fd);
+        _fd = -1;
+#endif
+        _data = nullptr;
+        _size = 0;
+    }
+
+private:
+    bool map(const std::string& path, size_t size, bool writable) {
+        close();
+        _writable = writable;
+#ifdef _WIN32
+        _file = CreateFileA(path.c_str(), writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+                            FILE_SHARE_READ, nullptr, writable ? CREATE_ALWAYS : OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (_file == INVALID_HANDLE_VALUE) { _file = nullptr; return false; }
+        if (!writable) {
+            LARGE_INTEGER sz;
+            if (!GetFileSizeEx(_file, &sz) || sz.QuadPart == 0) { CloseHandle(_file); _file = nullptr; return false; }
+            size = static_cast<size_t>(sz.QuadPart);
+        }
+        const uint64_t sz64 = size;
+        _mapping = CreateFileMappingA(_file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY,
+                                      static_cast<DWORD>(sz64 >> 32), static_cast<DWORD>(sz64), nullptr);
+        if (!_mapping) { CloseHandle(_file); _file = nullptr; return false; }
+        _data = static_cast<uint8_t*>(MapViewOfFile(_mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size));
+        if (!_data) { CloseHandle(_mapping); CloseHandle(_file); _mapping = _file = nullptr; return false; }
+#else
+        _fd = ::open(path.c_str(), writable ? (O_RDWR | O_CREAT | O_TRUNC) : O_RDONLY, 0644);
+        if (_fd < 0) return false;
+        if (writable) {
+            if (ftruncate(_fd, static_cast<off_t>(size)) != 0) { ::close(_fd); _fd = -1; return false; }
+        } else {
+            struct stat st;
+            if (fstat(_fd, &st) != 0 || st.st_size == 0) { ::close(_fd); _fd = -1; return false; }
+            size = static_cast<size_t>(st.st_size);
+        }
+        void* p = mmap(nullptr, size, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, _fd, 0);
+        if (p == MAP_FAILED) { ::close(_fd); _fd = -1; return false; }
+        _data = static_cast<uint8_t*>(p);
+#endif
+        _size = size;
+        return true;
+    }
+
+    uint8_t* _data = nullptr;
+    size_t _size = 0;
+    bool _writable = false;
+#ifdef _WIN32
+    HANDLE _file = nullptr;
+    HANDLE _mapping = nullptr;
+#else
+    int _fd = -1;
+#endif
+};
+
+constexpr size_t align8(size_t n) { return (n + 7) & ~size_t(7); }
+
+std::string segment_path(const std::string& dir, uint32_t index) {
+    char name[32];
+    std::snprintf(name, sizeof name, "segment-%06u.zlog", index);
+    return dir + "/" + name;
+}
+
+std::string index_path(const std::string& dir) { return dir + "/index.zidx"; }
+
+uint64_t now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+template <class T>
+T load(const uint8_t* p) {
+    T v;
+    std::memcpy(&v, p, sizeof v);
+    return v;
+}
+
+} // namespace
+
+// ---- LogWriter ----
+
+// Staging buffer filled by RX threads plus the background thread that drains it into the
+// mapped segments. Records are staged already encoded, so writing them is a memcpy.
+class LogWriter {
+public:
+    LogWriter(const std::string& dir, const RecorderOptions& opts) : _dir(dir), _opts(opts) {
+        std::filesystem::create_directories(dir);
+        _index = std::fopen(index_path(dir).c_str(), "wb");
+        if (!_index) throw std::runtime_error("recorder: cannot create " + index_path(dir));
+        _staging.reserve(std::min<size_t>(_opts.buffer_bytes, size_t(1) << 20));
+        _thread = std::thread([this] { run(); });
+    }
+
+    ~LogWriter() { close(); }
+
+    // RX threads: never blocks on I/O
+    void append(const std::string& key, BytesView payload) {
+        const size_t key_len = std::min<size_t>(key.size(), UINT16_MAX);
+        const size_t size = align8(zlog::kRecordHeaderSize + key_len + payload.size);
+        if (payload.size > UINT32_MAX - 64) { _dropped.fetch_add(1, std::memory_order_relaxed); return; }
+        bool wake = false;
+        {
+            std::lock_guard<std::mutex> lk(_mx);
+            const uint64_t ts = now_ns();  // under the lock, so timestamps follow log order
+            if (_closed || _staging.size() + size > _opts.buffer_bytes) {
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            const size_t at = _staging.size();
+            _staging.resize(at + size);
+            uint8_t* p = _staging.data() + at;
+            const uint32_t size32 = static_cast<uint32_t>(size);
+            const uint16_t key16 = static_cast<uint16_t>(key_len), flags = 0;
+            const uint32_t len32 = static_cast<uint32_t>(payload.size), zero = 0;
+            std::memcpy(p, &size32, 4);
+            std::memcpy(p + 4, &key16, 2);
+            std::memcpy(p + 6, &flags, 2);
+            std::memcpy(p + 8, &ts, 8);
+            std::memcpy(p + 16, &len32, 4);
+            std::memcpy(p + 20, &zero, 4);
+            std::memcpy(p + zlog::kRecordHeaderSize, key.data(), key_len);
+            if (payload.size) std::memcpy(p + zlog::kRecordHeaderSize + key_len, payload.data, payload.size);
+            std::memset(p + zlog::kRecordHeaderSize + key_len + payload.size, 0,
+                        size - zlog::kRecordHeaderSize - key_len - payload.size);
+            wake = _staging.size() >= _opts.buffer_bytes / 4;
+        }
+        if (wake) _cv.notify_one();
+    }
+
+    void close() {
+        {
+            std::lock_guard<std::mutex> lk(_mx);
+            if (_closed) return;
+            _closed = true;
+        }
+        _cv.notify_one();
+        if (_thread.joinable()) _thread.join();
+        _seg.close(_seg_used);
+        if (_index) std::fclose(_index);
+        _index = nullptr;
+    }
+
+    uint64_t recorded() const { return _recorded.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+    uint64_t bytes() const { return _bytes.load(std::memory_order_relaxed); }
+
+private:
+    void run() {
+        std::vector<uint8_t> batch;
+        for (;;) {
+            bool closing;
+            {
+                std::unique_lock<std::mutex> lk(_mx);
+                _cv.wait_for(lk, _opts.flush_interval, [&] { return _closed || _staging.size() >= _opts.buffer_bytes / 4; });
+                closing = _closed;
+                batch.swap(_staging);  // RX threads keep appending into the old batch buffer
+            }
+            write_batch(batch);
+            batch.clear();
+            if (closing) return;
+        }
+    }
+
+    void write_batch(const std::vector<uint8_t>& batch) {
+        for (size_t off = 0; off < batch.size();) {
+            const uint8_t* rec = batch.data() + off;
+            const uint32_t size = load<uint32_t>(rec);
+            if (!_seg.is_open() || _seg_used + size > _seg.size()) roll(size);
+            if (!_seg.is_open()) {  // could not create a segment; count and move on
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+                off += size;
+                continue;
+            }
+            if (_since_index++ % zlog::kIndexStride == 0) add_index(load<uint64_t>(rec + 8));
+            std::memcpy(_seg.data() + _seg_used, rec, size);
+            _seg_used += size;
+            off += size;
+            _recorded.fetch_add(1, std::memory_order_relaxed);
+            _bytes.fetch_add(size, std::memory_order_relaxed);
+        }
+        if (_index) std::fflush(_index);
+    }
+
+    // Finishes the current segment and maps the next, large enough for a `need`-byte record
+    void roll(size_t need) {
+        if (_seg.is_open()) {
+            _seg.close(_seg_used);
+            ++_seg_index;
+        }
+        const size_t size = std::max(_opts.segment_bytes, zlog::kSegmentHeaderSize + need + 8);
+        if (!_seg.create(segment_path(_dir, _seg_index), size)) return;
+        uint8_t* h = _seg.data();
+        std::memset(h, 0, zlog::kSegmentHeaderSize);
+        std::memcpy(h, zlog::kMagic, 8);
+        const uint32_t version = zlog::kVersion, hdr = static_cast<uint32_t>(zlog::kSegmentHeaderSize);
+        std::memcpy(h + 8, &version, 4);
+        std::memcpy(h + 12, &hdr, 4);
+        std::memcpy(h + 16, &_seg_index, 4);
+        _seg_used = zlog::kSegmentHeaderSize;
+        _since_index = 0;  // first record of every segment is indexed
+    }
+
+    void add_index(uint64_t ts) {
+        if (!_index) return;
+        const zlog::IndexEntry e{ts, _seg_index, static_cast<uint32_t>(_seg_used)};
+        std::fwrite(&e, sizeof e, 1, _index);
+    }
+
+    const std::string _dir;
+    const RecorderOptions _opts;
+    std::atomic<uint64_t> _recorded{0};
+    std::atomic<uint64_t> _dropped{0};
+    std::atomic<uint64_t> _bytes{0};
+
+    std::mutex _mx;
+    std::condition_variable _cv;
+    std::vector<uint8_t> _staging;
+    bool _closed = false;
+    std::thread _thread;
+
+    // Writer thread only
+    MappedFile _seg;
+    size_t _seg_used = 0;
+    uint32_t _seg_index = 0;
+    uint64_t _since_index = 0;
+    std::FILE* _index = nullptr;
+};
+
+// ---- Recorder ----
+
+Recorder::Recorder(Node& node, const std::string& key_expr, const std::string& dir,
+                   const RecorderOptions& opts)
+    : _node(&node), _key_expr(key_expr), _writer(std::make_shared<LogWriter>(dir, opts)) {
+    auto writer = _writer;
+    const bool created = node.create_view_subscriber(key_expr, [writer](const std::string& key, BytesView payload) {
+        writer->append(key, payload);
+    });
+    if (!created) {
+        _writer->close();
+        throw std::runtime_error("recorder: '" + key_expr + "' already has a subscriber");
+    }
+}
+
+Recorder::~Recorder() { stop(); }
+
+void Recorder::stop() {
+    if (!_node) return;
+    _node->remove_subscriber(_key_expr);
+    _node = nullptr;
+    _writer->close();
+}
+
+uint64_t Recorder::recorded() const { return _writer->recorded(); }
+uint64_t Recorder::dropped() const { return _writer->dropped(); }
+uint64_t Recorder::bytes() const { return _writer->bytes(); }
+
+// ---- LogReader ----
+
+struct LogReader::Mapping {
+    MappedFile file;
+};
+
+LogReader::LogReader(const std::string& dir) : _dir(dir), _map(std::make_unique<Mapping>()) {
+    for (uint32_t i = 0;; ++i) {
+        std::string p = segment_path(dir, i);
+        if (!std::filesystem::exists(p)) break;
+        _segments.push_back(std::move(p));
+    }
+    if (_segments.empty()) throw std::runtime_error("recording: no segments in " + dir);
+
+    if (std::FILE* f = std::fopen(index_path(dir).c_str(), "rb")) {
+        zlog::IndexEntry e;
+        while (std::fread(&e, sizeof e, 1, f) == 1) _index.push_back(e);
+        std::fclose(f);
+    }
+    open_segment(0);
+}
+
+LogReader::~LogReader() = default;
+
+bool LogReader::open_segment(size_t i) {
+    _current = i;
+    _offset = zlog::kSegmentHeaderSize;
+    if (i >= _segments.size() || !_map->file.open_read(_segments[i])) {
+        _map->file.close();
+        return false;
+    }
+    const uint8_t* h = _map->file.data();
+    if (_map->file.size() < zlog::kSegmentHeaderSize || std::memcmp(h, zlog::kMagic, 8) != 0 ||
+        load<uint32_t>(h + 8) != zlog::kVersion) {
+        _map->file.close();
+        return false;
+    }
+    _offset = load<uint32_t>(h + 12);
+    return true;
+}
+
+bool LogReader::next(LogRecord& out) {
+    while (_current < _segments.size()) {
+        if (_map->file.is_open() && _offset + zlog::kRecordHeaderSize <= _map->file.size()) {
+            const uint8_t* rec = _map->file.data() + _offset;
+            const uint32_t size = load<uint32_t>(rec);
+            const uint16_t key_len = load<uint16_t>(rec + 4);
+            const uint32_t len = load<uint32_t>(rec + 16);
+            if (size != 0 && _offset + size <= _map->file.size() &&
+                zlog::kRecordHeaderSize + key_len + size_t(len) <= size) {
+                out.timestamp_ns = load<uint64_t>(rec + 8);
+                out.key = std::string_view(reinterpret_cast<const char*>(rec + zlog::kRecordHeaderSize), key_len);
+                out.payload = BytesView{rec + zlog::kRecordHeaderSize + key_len, len};
+                _offset += size;
+                return true;
+            }
+        }
+        // End of this segment (or a torn tail after a crash): move on
+        if (_current + 1 >= _segments.size()) {
+            _current = _segments.size();
+            return false;
+        }
+        open_segment(_current + 1);
+    }
+    return false;
+}
+
+void LogReader::seek(uint64_t timestamp_ns) {
+    // Start from the last indexed record before the target...
+    auto it = std::lower_bound(_index.begin(), _index.end(), timestamp_ns,
+                               [](const zlog::IndexEntry& e, uint64_t ts) { return e.timestamp_ns < ts; });
+    if (it == _index.begin()) {
+        open_segment(0);
+    } else {
+        --it;
+        if (!open_segment(it->segment)) return;
+        _offset = it->offset;
+    }
+
+    // ...then scan forward and stop in front of the first record at or after it
+    LogRecord rec;
+    for (;;) {
+        const size_t seg = _current, off = _offset;
+        if (!next(rec)) return;
+        if (rec.timestamp_ns >= timestamp_ns) {
+            if (_current != seg) open_segment(seg);
+            _offset = off;
+            return;
+        }
+    }
+}
+
+} // namespace ubicoders_zenoh
@@ -0,0 +1,105 @@
+// recorder.h
+#pragma once
+
+#include "node.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ubicoders_zenoh {
+
+// On-disk layout of a recording directory:
+//   segment-000000.zlog, segment-000001.zlog, ...   memory-mapped, fixed size while written
+//   index.zidx                                      sparse (timestamp, segment, offset) entries
+// A segment is a 64-byte header followed by 8-byte aligned records:
+//   [u32 size][u16 key_len][u16 flags][u64 timestamp_ns][u32 payload_len][u32 0][key][payload][pad]
+// `size` covers the whole record; a zero `size` marks the end of the written part.
+namespace zlog {
+constexpr char kMagic[8] = {'Z', 'N', 'O', 'D', 'E', 'L', 'O', 'G'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kSegmentHeaderSize = 64;
+constexpr size_t kRecordHeaderSize = 24;
+constexpr uint32_t kIndexStride = 256;  // records between index entries (plus one per segment)
+
+struct IndexEntry {
+    uint64_t timestamp_ns;
+    uint32_t segment;
+    uint32_t offset;
+};
+} // namespace zlog
+
+struct RecorderOptions {
+    size_t segment_bytes = size_t(64) << 20;
+    // Samples waiting for the writer thread; beyond this they are dropped, never blocking RX
+    size_t buffer_bytes = size_t(32) << 20;
+    std::chrono::milliseconds flush_interval{20};
+};
+
+class LogWriter;
+
+// Captures every sample matching a (wildcard) key expression into a recording directory.
+// The subscription callback only appends the sample to an in-memory staging buffer; a
+// background thread moves full batches into the mapped segments.
+class Recorder {
+public:
+    Recorder(Node& node, const std::string& key_expr, const std::string& dir,
+             const RecorderOptions& opts = RecorderOptions());
+    ~Recorder();
+    Recorder(const Recorder&) = delete;
+    Recorder& operator=(const Recorder&) = delete;
+
+    // Unsubscribes, writes out what is buffered and closes the files. Call it before the
+    // node goes away; the destructor does it too.
+    void stop();
+
+    uint64_t recorded() const;  // samples written to disk
+    uint64_t dropped() const;   // samples lost because the staging buffer was full
+    uint64_t bytes() const;     // record bytes written, headers included
+
+private:
+    Node* _node;
+    std::string _key_expr;
+    std::shared_ptr<LogWriter> _writer;
+};
+
+// One recorded sample. `key` and `payload` point into the mapped segment and stay valid
+// until the reader moves to another segment.
+struct LogRecord {
+    uint64_t timestamp_ns = 0;  // system clock at reception
+    std::string_view key;
+    BytesView payload;
+};
+
+// Sequential reader over a recording directory.
+class LogReader {
+public:
+    explicit LogReader(const std::string& dir);  // throws if `dir` holds no segments
+    ~LogReader();
+    LogReader(const LogReader&) = delete;
+    LogReader& operator=(const LogReader&) = delete;
+
+    bool next(LogRecord& out);
+    // Positions the reader on the first record at or after `timestamp_ns` (via the index)
+    void seek(uint64_t timestamp_ns);
+    void rewind() { open_segment(0); }
+
+    size_t segments() const { return _segments.size(); }
+
+private:
+    bool open_segment(size_t i);
+
+    struct Mapping;
+    std::string _dir;
+    std::vector<std::string> _segments;
+    std::vector<zlog::IndexEntry> _index;
+    std::unique_ptr<Mapping> _map;
+    size_t _current = 0;
+    size_t _offset = 0;
+};
+
+} // namespace ubicoders_zenoh
@@ -0,0 +1,86 @@
+// reply_cache.cpp
+#include "reply_cache.h"
+
+namespace ubicoders_zenoh {
+
+// key \0 size(params) params payload: the whole payload, so a hit is never a lookalike
+std::string ReplyCache::make_key(std::string_view key, std::string_view params, BytesView payload) {
+    const uint64_t n = params.size();
+    std::string out;
+    out.reserve(key.size() + 1 + sizeof(n) + params.size() + payload.size);
+    out.append(key).push_back('\0');
+    out.append(reinterpret_cast<const char*>(&n), sizeof(n));
+    out.append(params);
+    out.append(reinterpret_cast<const char*>(payload.data), payload.size);
+    return out;
+}
+
+size_t ReplyCache::bytes() const {
+    std::lock_guard<std::mutex> lk(_mx);
+    return _bytes;
+}
+
+void ReplyCache::erase_locked(std::unordered_map<std::string, Entry>::iterator it) {
+    _bytes -= it->second.reply->size() + it->first.size();
+    _lru.erase(it->second.lru);
+    _entries.erase(it);
+}
+
+ReplyCache::Lookup ReplyCache::lookup(const std::string& key, Reply& hit, const std::function<Waiter()>& park) {
+    std::lock_guard<std::mutex> lk(_mx);
+    auto it = _entries.find(key);
+    if (it != _entries.end()) {
+        if (it->second.expires > std::chrono::steady_clock::now()) {
+            _lru.splice(_lru.begin(), _lru, it->second.lru);
+            hit = it->second.reply;
+            _hits.fetch_add(1, std::memory_order_relaxed);
+            return Lookup::Hit;
+        }
+        erase_locked(it);
+    }
+    auto fl = _inflight.find(key);
+    if (fl != _inflight.end()) {
+        fl->second.push_back(park());
+        _hits.fetch_add(1, std::memory_order_relaxed);
+        return Lookup::Joined;
+    }
+    _inflight.emplace(key, std::vector<Waiter>());
+    return Lookup::Leader;
+}
+
+void ReplyCache::complete(const std::string& key, Reply reply) {
+    std::vector<Waiter> waiters;
+    {
+        std::lock_guard<std::mutex> lk(_mx);
+        auto fl = _inflight.find(key);
+        if (fl != _inflight.end()) {
+            waiters.swap(fl->second);
+            _inflight.erase(fl);
+        }
+        const size_t n = reply->size() + key.size();
+        if (n <= _opts.max_bytes) {
+            auto old = _entries.find(key);
+            if (old != _entries.end()) erase_locked(old);
+            while (_bytes + n > _opts.max_bytes && !_lru.empty()) erase_locked(_entries.find(*_lru.back()));
+            auto it = _entries.emplace(key, Entry{reply, std::chrono::steady_clock::now() + _opts.ttl, {}}).first;
+            _lru.push_front(&it->first);
+            it->second.lru = _lru.begin();
+            _bytes += n;
+        }
+    }
+    for (auto& w : waiters) w(reply, std::string());
+}
+
+void ReplyCache::fail(const std::string& key, const std::string& message) {
+    std::vector<Waiter> waiters;
+    {
+        std::lock_guard<std::mutex> lk(_mx);
+        auto fl = _inflight.find(key);
+        if (fl == _inflight.end()) return;
+        waiters.swap(fl->second);
+        _inflight.erase(fl);
+    }
+    for (auto& w : waiters) w(nullptr, message);
+}
+
+} // namespace ubicoders_zenoh
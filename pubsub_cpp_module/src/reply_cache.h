@@ -0,0 +1,73 @@
+// reply_cache.h
+#pragma once
+
+#include "bytes_view.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace ubicoders_zenoh {
+
+struct ReplyCacheOptions {
+    std::chrono::milliseconds ttl{0};     // how long a reply is served again; 0 disables the cache
+    size_t max_bytes = size_t(16) << 20;  // reply and key bytes kept; least recently used go first
+};
+
+// Replies of an idempotent server, keyed by query key + parameters + payload bytes.
+// Concurrent misses on one key are coalesced: the first query (the leader) runs the
+// handler, the others wait for its outcome. Only successful replies are stored.
+class ReplyCache {
+public:
+    using Reply = std::shared_ptr<const std::vector<uint8_t>>;
+    // Outcome for a query that joined an in-flight miss: the reply, or null and an error
+    using Waiter = std::function<void(const Reply& reply, const std::string& error)>;
+
+    enum class Lookup {
+        Hit,     // `hit` holds the cached reply
+        Joined,  // the waiter made by `park` runs once the leader finishes
+        Leader,  // run the handler, then complete() or fail() the key
+    };
+
+    explicit ReplyCache(const ReplyCacheOptions& opts) : _opts(opts) {}
+    ReplyCache(const ReplyCache&) = delete;
+    ReplyCache& operator=(const ReplyCache&) = delete;
+
+    static std::string make_key(std::string_view key, std::string_view params, BytesView payload);
+
+    // `park` is only called (under the cache lock) when the query joins an in-flight miss
+    Lookup lookup(const std::string& key, Reply& hit, const std::function<Waiter()>& park);
+    void complete(const std::string& key, Reply reply);
+    void fail(const std::string& key, const std::string& message);
+
+    uint64_t hits() const { return _hits.load(std::memory_order_relaxed); }  // coalesced included
+    size_t bytes() const;
+
+private:
+    struct Entry {
+        Reply reply;
+        std::chrono::steady_clock::time_point expires;
+        std::list<const std::string*>::iterator lru;
+    };
+
+    void erase_locked(std::unordered_map<std::string, Entry>::iterator it);
+
+    const ReplyCacheOptions _opts;
+    mutable std::mutex _mx;
+    std::unordered_map<std::string, Entry> _entries;
+    std::list<const std::string*> _lru;  // keys owned by _entries; front: most recently used
+    std::unordered_map<std::string, std::vector<Waiter>> _inflight;
+    size_t _bytes = 0;
+    std::atomic<uint64_t> _hits{0};
+};
+
+} // namespace ubicoders_zenoh
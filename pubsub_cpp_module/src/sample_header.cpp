@@ -0,0 +1,104 @@
+// sample_header.cpp
+#include "sample_header.h"
+
+namespace ubicoders_zenoh {
+
+namespace {
+void put_u32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; ++i) p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+void put_u64(uint8_t* p, uint64_t v) {
+    for (int i = 0; i < 8; ++i) p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+uint32_t get_u32(const uint8_t* p) {
+    uint32_t v = 0;
+    for (int i = 0; i < 4; ++i) v |= static_cast<uint32_t>(p[i]) << (8 * i);
+    return v;
+}
+uint64_t get_u64(const uint8_t* p) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; ++i) v |= static_cast<uint64_t>(p[i]) << (8 * i);
+    return v;
+}
+} // namespace
+
+size_t SampleHeader::encode(uint8_t out[kMaxSize]) const {
+    size_t n = 0;
+    if (fragment) {
+        put_u32(out + n, FragmentHeader::kMagic);
+        put_u64(out + n + 4, fragment->source);
+        put_u32(out + n + 12, fragment->transfer);
+        put_u32(out + n + 16, fragment->total);
+        put_u32(out + n + 20, fragment->offset);
+        n += FragmentHeader::kSize;
+    }
+    if (compression) {
+        put_u32(out + n, CompressionHeader::kMagic);
+        out[n + 4] = static_cast<uint8_t>(compression->codec);
+        out[n + 5] = out[n + 6] = out[n + 7] = 0;
+        put_u32(out + n + 8, compression->raw_size);
+        n += CompressionHeader::kSize;
+    }
+    if (delta) {
+        put_u32(out + n, DeltaHeader::kMagic);
+        out[n + 4] = delta->keyframe ? 1 : 0;
+        out[n + 5] = out[n + 6] = out[n + 7] = 0;
+        put_u64(out + n + 8, delta->source);
+        put_u32(out + n + 16, delta->seq);
+        put_u32(out + n + 20, delta->size);
+        n += DeltaHeader::kSize;
+    }
+    if (stamp) {
+        put_u32(out + n, StampHeader::kMagic);
+        put_u32(out + n + 4, 0);
+        put_u64(out + n + 8, stamp->source);
+        put_u64(out + n + 16, stamp->seq);
+        put_u64(out + n + 24, stamp->time_ns);
+        n += StampHeader::kSize;
+    }
+    return n;
+}
+
+bool SampleHeader::decode(const uint8_t* in, size_t len, SampleHeader& out) {
+    out = SampleHeader();
+    size_t n = 0;
+    while (len - n >= 4) {
+        const uint32_t magic = get_u32(in + n);
+        if (magic == FragmentHeader::kMagic && len - n >= FragmentHeader::kSize) {
+            FragmentHeader f;
+            f.source = get_u64(in + n + 4);
+            f.transfer = get_u32(in + n + 12);
+            f.total = get_u32(in + n + 16);
+            f.offset = get_u32(in + n + 20);
+            if (f.total == 0) break;
+            out.fragment = f;
+            n += FragmentHeader::kSize;
+        } else if (magic == CompressionHeader::kMagic && len - n >= CompressionHeader::kSize) {
+            CompressionHeader c;
+            c.codec = static_cast<Compression>(in[n + 4]);
+            c.raw_size = get_u32(in + n + 8);
+            out.compression = c;
+            n += CompressionHeader::kSize;
+        } else if (magic == DeltaHeader::kMagic && len - n >= DeltaHeader::kSize) {
+            DeltaHeader d;
+            d.keyframe = (in[n + 4] & 1) != 0;
+            d.source = get_u64(in + n + 8);
+            d.seq = get_u32(in + n + 16);
+            d.size = get_u32(in + n + 20);
+            out.delta = d;
+            n += DeltaHeader::kSize;
+        } else if (magic == StampHeader::kMagic && len - n >= StampHeader::kSize) {
+            StampHeader st;
+            st.source = get_u64(in + n + 8);
+            st.seq = get_u64(in + n + 16);
+            st.time_ns = get_u64(in + n + 24);
+            out.stamp = st;
+            n += StampHeader::kSize;
+        } else {
+            break;
+        }
+    }
+    return !out.empty();
+}
+
+} // namespace ubicoders_zenoh
@@ -0,0 +1,73 @@
+// sample_header.h
+#pragma once
+
+#include "codec.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace ubicoders_zenoh {
+
+// Wire records a publisher attaches to a sample, as its zenoh attachment. Each record is
+// fixed-size, little-endian and starts with its own magic. Samples without an attachment
+// are plain payloads.
+
+// One fragment of a chunked payload (see PublisherOptions::fragment_bytes)
+struct FragmentHeader {
+    static constexpr uint32_t kMagic = 0x3152465a;  // "ZFR1"
+    static constexpr size_t kSize = 24;
+
+    uint64_t source = 0;    // random per publisher, so several publishers can share a key
+    uint32_t transfer = 0;  // per-publisher payload counter
+    uint32_t total = 0;     // bytes of the whole payload (compressed, if it is)
+    uint32_t offset = 0;    // of this fragment within the payload
+};
+
+// The payload (after reassembly) is compressed (see PublisherOptions::compression)
+struct CompressionHeader {
+    static constexpr uint32_t kMagic = 0x3150435a;  // "ZCP1"
+    static constexpr size_t kSize = 12;
+
+    Compression codec = Compression::None;
+    uint32_t raw_size = 0;  // bytes once decompressed
+};
+
+// The payload (after decompression) is a keyframe or a delta (see PublisherOptions::delta)
+struct DeltaHeader {
+    static constexpr uint32_t kMagic = 0x314c445a;  // "ZDL1"
+    static constexpr size_t kSize = 24;
+
+    bool keyframe = false;
+    uint64_t source = 0;  // random per publisher, as in FragmentHeader
+    uint32_t seq = 0;     // per-publisher sample counter; a requested keyframe is the next sample, with the next seq
+    uint32_t size = 0;    // bytes of the full payload
+};
+
+// Source sequence number and timestamp of the payload (see PublisherOptions::stamp)
+struct StampHeader {
+    static constexpr uint32_t kMagic = 0x3154535a;  // "ZST1"
+    static constexpr size_t kSize = 32;
+
+    uint64_t source = 0;   // random per publisher, as in FragmentHeader
+    uint64_t seq = 0;      // per-publisher payload counter, from 1
+    uint64_t time_ns = 0;  // publisher's system clock at publish, since the Unix epoch
+};
+
+struct SampleHeader {
+    static constexpr size_t kMaxSize =
+        FragmentHeader::kSize + CompressionHeader::kSize + DeltaHeader::kSize + StampHeader::kSize;
+
+    std::optional<FragmentHeader> fragment;
+    std::optional<CompressionHeader> compression;
+    std::optional<DeltaHeader> delta;
+    std::optional<StampHeader> stamp;
+
+    bool empty() const { return !fragment && !compression && !delta && !stamp; }
+    // Writes the present records; returns the bytes written
+    size_t encode(uint8_t out[kMaxSize]) const;
+    // Reads records up to the first unknown one. False when there is no known record.
+    static bool decode(const uint8_t* in, size_t len, SampleHeader& out);
+};
+
+} // namespace ubicoders_zenoh
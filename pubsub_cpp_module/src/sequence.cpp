@@ -0,0 +1,90 @@
+// sequence.cpp
+#include "sequence.h"
+
+#include <algorithm>
+
+namespace ubicoders_zenoh {
+
+SequenceTracker::Result SequenceTracker::observe(uint64_t source, uint64_t seq) {
+    std::lock_guard<std::mutex> lk(_mx);
+    Result r;
+    auto found = _sources.find(source);
+    if (found == _sources.end()) {
+        if (_sources.size() >= _max_sources) {
+            // Full: forget the publisher heard from least recently
+            _sources.erase(_recency.back().id);
+            _recency.pop_back();
+        }
+        _recency.push_front(Source{source, seq, 0});
+        _sources.emplace(source, _recency.begin());
+        return r;
+    }
+    _recency.splice(_recency.begin(), _recency, found->second);
+    const auto it = found->second;
+    if (seq > it->newest) {
+        // Shift the window up; the skipped numbers become holes, and the oldest fall out
+        // of it, staying counted as missing
+        const uint64_t step = seq - it->newest;
+        r.missing = step - 1;
+        const uint64_t skipped = r.missing < kWindow ? (uint64_t(1) << r.missing) - 1 : ~uint64_t(0);
+        it->holes = (step < kWindow ? it->holes << step : 0) | skipped;
+        it->newest = seq;
+        return r;
+    }
+    const uint64_t back = it->newest - seq;
+    if (back == 0) {
+        r.duplicate = true;
+        return r;
+    }
+    const uint64_t bit = back <= kWindow ? uint64_t(1) << (back - 1) : 0;
+    if (bit && !(it->holes & bit)) {
+        r.duplicate = true;
+    } else {
+        r.reordered = true;  // past the window it cannot be told from a repeat: called late
+        r.recovered = bit != 0;
+        it->holes &= ~bit;
+    }
+    return r;
+}
+
+// ---- ReplayFilter ----
+
+bool ReplayFilter::admit_live_locked(uint64_t source, uint64_t seq) {
+    if (!_fetching && std::chrono::steady_clock::now() - _fetched_at > kGrace) {
+        _sources.clear();  // whatever a fetched value could still shadow has arrived by now
+        update_active_locked();
+        return true;
+    }
+    auto it = std::find_if(_sources.begin(), _sources.end(), [&](const Source& s) { return s.id == source; });
+    if (it != _sources.end() && it->fetched && seq <= it->fetched) return false;
+    if (_fetching) {
+        if (it == _sources.end()) _sources.push_back(Source{source, seq, 0});
+        else it->live = std::max(it->live, seq);
+    } else if (it != _sources.end()) {
+        _sources.erase(it);  // past its fetched value: nothing left to merge for this source
+        update_active_locked();
+    }
+    return true;
+}
+
+bool ReplayFilter::admit_fetched_locked(uint64_t source, uint64_t seq) {
+    auto it = std::find_if(_sources.begin(), _sources.end(), [&](const Source& s) { return s.id == source; });
+    if (it == _sources.end()) {
+        _sources.push_back(Source{source, 0, seq});
+        return true;
+    }
+    if (seq <= it->live || seq <= it->fetched) return false;
+    it->fetched = seq;
+    return true;
+}
+
+void ReplayFilter::fetch_done() {
+    std::lock_guard<std::mutex> lk(_mx);
+    _fetching = false;
+    _fetched_at = std::chrono::steady_clock::now();
+    _sources.erase(std::remove_if(_sources.begin(), _sources.end(), [](const Source& s) { return !s.fetched; }),
+                   _sources.end());
+    update_active_locked();
+}
+
+} // namespace ubicoders_zenoh
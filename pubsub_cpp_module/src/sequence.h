@@ -0,0 +1,109 @@
+// sequence.h
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace ubicoders_zenoh {
+
+// Follows the sequence numbers of each publisher (StampHeader::source) heard by one
+// subscription, to count lost and out-of-order payloads. The last kWindow sequence numbers
+// below the newest are remembered, so a hole filled late is told apart from a repeat.
+class SequenceTracker {
+public:
+    struct Result {
+        uint64_t missing = 0;    // sequence numbers skipped since the newest one seen
+        bool reordered = false;  // older than the newest one seen
+        bool recovered = false;  // reordered, and fills a hole reported as missing before
+        bool duplicate = false;  // seen before: neither missing nor reordered
+    };
+
+    static constexpr uint64_t kWindow = 64;
+
+    // Past `max_sources` publishers, the one heard from least recently is forgotten. Its next
+    // payload starts tracking it afresh, so whatever it lost while forgotten goes unreported.
+    explicit SequenceTracker(size_t max_sources = 16) : _max_sources(max_sources ? max_sources : 1) {}
+    SequenceTracker(const SequenceTracker&) = delete;
+    SequenceTracker& operator=(const SequenceTracker&) = delete;
+
+    // The first payload heard from a source only starts tracking it
+    Result observe(uint64_t source, uint64_t seq);
+
+private:
+    struct Source {
+        uint64_t id;
+        uint64_t newest;
+        uint64_t holes;  // bit i: newest - 1 - i not seen yet
+    };
+    using Recency = std::list<Source>;  // most recently heard from first
+
+    const size_t _max_sources;
+    std::mutex _mx;
+    Recency _recency;
+    std::unordered_map<uint64_t, Recency::iterator> _sources;
+};
+
+// Merges the last values a subscription fetched on startup with its live stream, so each
+// stamped payload (StampHeader source and seq) is delivered at most once and a fetched
+// value never follows a newer live one. Both paths deliver under the filter's lock until
+// the fetch is over and the live stream has moved past every fetched value, or kGrace
+// after the fetch for publishers that went quiet; from then on live payloads skip it.
+class ReplayFilter {
+public:
+    // Live payloads still in flight when the fetch ends arrive well within this
+    static constexpr std::chrono::milliseconds kGrace{1000};
+
+    ReplayFilter() = default;
+    ReplayFilter(const ReplayFilter&) = delete;
+    ReplayFilter& operator=(const ReplayFilter&) = delete;
+
+    // Calls `deliver()` unless a fetched value already covered this payload; returns
+    // whether it did
+    template <class F>
+    bool live(uint64_t source, uint64_t seq, F&& deliver) {
+        if (!_active.load(std::memory_order_acquire)) {
+            deliver();
+            return true;
+        }
+        std::lock_guard<std::mutex> lk(_mx);
+        if (!admit_live_locked(source, seq)) return false;
+        deliver();
+        return true;
+    }
+
+    // Calls `deliver()` unless the live stream already delivered this payload or a newer one
+    template <class F>
+    bool fetched(uint64_t source, uint64_t seq, F&& deliver) {
+        std::lock_guard<std::mutex> lk(_mx);
+        if (!admit_fetched_locked(source, seq)) return false;
+        deliver();
+        return true;
+    }
+
+    void fetch_done();  // no more fetched values will come
+
+private:
+    struct Source {
+        uint64_t id;
+        uint64_t live = 0;     // newest live seq while fetching (0: none)
+        uint64_t fetched = 0;  // seq of the fetched value (0: none)
+    };
+
+    bool admit_live_locked(uint64_t source, uint64_t seq);
+    bool admit_fetched_locked(uint64_t source, uint64_t seq);
+    void update_active_locked() { _active.store(_fetching || !_sources.empty(), std::memory_order_release); }
+
+    std::mutex _mx;
+    std::atomic<bool> _active{true};
+    bool _fetching = true;
+    std::chrono::steady_clock::time_point _fetched_at;  // when fetch_done was called
+    std::vector<Source> _sources;
+};
+
+} // namespace ubicoders_zenoh
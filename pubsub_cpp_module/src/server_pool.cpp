@@ -0,0 +1,113 @@
+// server_pool.cpp
+#include "server_pool.h"
+
+namespace ubicoders_zenoh {
+
+// ---- TaskPool ----
+
+TaskPool::TaskPool(size_t threads) : _core(std::make_shared<Core>()) {
+    if (threads == 0) threads = 1;
+    for (size_t i = 0; i < threads; ++i) _threads.emplace_back([core = _core] { core->worker_loop(); });
+}
+
+TaskPool::~TaskPool() { stop(); }
+
+void TaskPool::post(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lk(_core->mx);
+        if (_core->stop) return;
+        _core->tasks.push_back(std::move(task));
+    }
+    _core->cv.notify_one();
+}
+
+void TaskPool::stop() {
+    std::deque<std::function<void()>> discarded;
+    {
+        std::lock_guard<std::mutex> lk(_core->mx);
+        if (_core->stop) return;
+        _core->stop = true;
+        discarded.swap(_core->tasks);
+    }
+    _core->cv.notify_all();
+    for (auto& t : _threads) {
+        if (!t.joinable()) continue;
+        // Stopped from its own task: the thread exits on its own and keeps the core alive
+        if (t.get_id() == std::this_thread::get_id()) t.detach();
+        else t.join();
+    }
+}
+
+void TaskPool::Core::worker_loop() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lk(mx);
+            cv.wait(lk, [&] { return stop || !tasks.empty(); });
+            if (stop) return;
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+// ---- ServerQueue ----
+
+ServerQueue::ServerQueue(std::shared_ptr<TaskPool> pool, bool owns_pool, size_t max_concurrency,
+                         size_t queue_depth)
+    : _pool(std::move(pool)), _owns_pool(owns_pool),
+      _max_concurrency(max_concurrency ? max_concurrency : 1), _queue_depth(queue_depth) {}
+
+size_t ServerQueue::waiting() const {
+    std::lock_guard<std::mutex> lk(_mx);
+    return _jobs.size();
+}
+
+bool ServerQueue::submit(Job job) {
+    bool post = false;
+    {
+        std::lock_guard<std::mutex> lk(_mx);
+        if (_closed || _jobs.size() + _running >= _max_concurrency + _queue_depth) {
+            _shed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        _jobs.push_back(std::move(job));
+        if (_drainers < _max_concurrency) {
+            ++_drainers;
+            post = true;
+        }
+    }
+    if (post) _pool->post([self = shared_from_this()] { self->drain(); });
+    return true;
+}
+
+// Runs jobs until the queue is empty, so a burst costs one pool task per concurrency slot
+void ServerQueue::drain() {
+    std::unique_lock<std::mutex> lk(_mx);
+    while (!_closed && !_jobs.empty()) {
+        Job job = std::move(_jobs.front());
+        _jobs.pop_front();
+        ++_running;
+        lk.unlock();
+        job(false);
+        job = nullptr;  // release the query before taking the lock again
+        lk.lock();
+        --_running;
+    }
+    --_drainers;
+}
+
+void ServerQueue::close() {
+    std::deque<Job> cancelled;
+    {
+        std::lock_guard<std::mutex> lk(_mx);
+        if (_closed) return;
+        _closed = true;
+        cancelled.swap(_jobs);
+    }
+    for (auto& job : cancelled) job(true);
+    if (_owns_pool) _pool->stop();
+}
+
+} // namespace ubicoders_zenoh
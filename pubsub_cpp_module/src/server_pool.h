@@ -0,0 +1,100 @@
+// server_pool.h
+#pragma once
+
+#include "reply_cache.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ubicoders_zenoh {
+
+// Where a server's query handler runs
+enum class ServerExecution {
+    Inline = 0,     // on the zenoh thread that delivered the query: no queueing, no limit
+    Shared = 1,     // on the node's query pool (NodeOptions::query_threads), shared by servers
+    Dedicated = 2,  // on `max_concurrency` threads owned by this server
+};
+
+struct ServerOptions {
+    ServerExecution execution = ServerExecution::Inline;
+    size_t max_concurrency = 4;  // handlers of this server running at once (pooled modes)
+    size_t queue_depth = 64;     // queries waiting for a slot; beyond that they are shed
+    std::string overload_reply = "overloaded";  // reply_err payload of a shed query
+    // Opt-in reply cache for idempotent handlers (any execution mode). Hits, and queries that
+    // match a miss already being handled, are answered without calling the handler.
+    ReplyCacheOptions cache;
+};
+
+// Fixed set of threads running posted tasks in FIFO order.
+class TaskPool {
+public:
+    explicit TaskPool(size_t threads);
+    ~TaskPool();
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    void post(std::function<void()> task);  // ignored once stopped
+    // Joins the threads; tasks not yet started are discarded. Safe to call from a task: that
+    // thread is detached and finishes on the shared core, never on `this`.
+    void stop();
+    size_t threads() const { return _threads.size(); }
+
+private:
+    // State the threads touch; each of them holds a reference
+    struct Core {
+        std::mutex mx;
+        std::condition_variable cv;
+        std::deque<std::function<void()>> tasks;
+        bool stop = false;
+
+        void worker_loop();
+    };
+
+    const std::shared_ptr<Core> _core;
+    std::vector<std::thread> _threads;
+};
+
+// Admission control for one server on a TaskPool: at most `max_concurrency` jobs run at
+// once, at most `queue_depth` more wait, and submit() refuses anything beyond that so the
+// caller can shed it right away. Jobs get `cancelled` = true when the queue closes first.
+class ServerQueue : public std::enable_shared_from_this<ServerQueue> {
+public:
+    using Job = std::function<void(bool cancelled)>;
+
+    // `owns_pool`: close() also stops `pool` (a dedicated pool)
+    ServerQueue(std::shared_ptr<TaskPool> pool, bool owns_pool, size_t max_concurrency, size_t queue_depth);
+    ServerQueue(const ServerQueue&) = delete;
+    ServerQueue& operator=(const ServerQueue&) = delete;
+
+    bool submit(Job job);
+    // Cancels the waiting jobs and refuses new ones; running jobs finish.
+    void close();
+
+    size_t waiting() const;
+    uint64_t shed() const { return _shed.load(std::memory_order_relaxed); }
+
+private:
+    void drain();
+
+    const std::shared_ptr<TaskPool> _pool;
+    const bool _owns_pool;
+    const size_t _max_concurrency;
+    const size_t _queue_depth;
+
+    mutable std::mutex _mx;
+    std::deque<Job> _jobs;
+    size_t _running = 0;   // jobs taken by a drain task
+    size_t _drainers = 0;  // drain tasks posted or running, <= _max_concurrency
+    bool _closed = false;
+    std::atomic<uint64_t> _shed{0};
+};
+
+} // namespace ubicoders_zenoh
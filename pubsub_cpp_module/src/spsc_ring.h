@@ -0,0 +1,107 @@
+// spsc_ring.h
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace ubicoders_zenoh {
+
+// Bounded single-producer / single-consumer ring of variable-length messages.
+// Each record is [uint32 len][payload] padded to 4 bytes; a record that would straddle the
+// end of the buffer is preceded by a wrap marker and written at offset 0 instead, so every
+// payload is contiguous and can be copied out with a single memcpy.
+class SpscByteRing {
+public:
+    // `capacity` is rounded up to a power of two (minimum 64 bytes).
+    explicit SpscByteRing(size_t capacity) {
+        size_t cap = 64;
+        while (cap < capacity) cap <<= 1;
+        _cap = cap;
+        _buf.reset(new uint8_t[cap]);
+    }
+
+    size_t capacity() const { return _cap; }
+
+    // Producer side. Returns false (message not written) when there is no room.
+    bool push(const uint8_t* data, size_t len) {
+        const size_t need = record_size(len);
+        if (need > _cap) return false;
+        uint64_t head = _head.load(std::memory_order_relaxed);
+        uint64_t tail = _tail.load(std::memory_order_acquire);
+        const size_t off = static_cast<size_t>(head & (_cap - 1));
+        const size_t contiguous = _cap - off;
+        size_t skip = contiguous < need ? contiguous : 0;
+        if (skip && head == tail) {
+            // Empty: both ends move to the next wrap boundary instead, so the skipped bytes do
+            // not count against the message. The consumer leaves _tail alone while empty.
+            head = tail = head + skip;
+            skip = 0;
+            _tail.store(tail, std::memory_order_relaxed);  // published by the _head release below
+        }
+        if (head + skip + need - tail > _cap) return false;
+        if (skip) {
+            write_len(off, kWrapMarker);
+            head += skip;
+        }
+        const size_t at = static_cast<size_t>(head & (_cap - 1));
+        write_len(at, static_cast<uint32_t>(len));
+        if (len) std::memcpy(&_buf[at + sizeof(uint32_t)], data, len);
+        _head.store(head + need, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Points `data`/`len` at the oldest message without consuming it.
+    bool peek(const uint8_t*& data, size_t& len) {
+        // _head first: a producer that moved both ends of an empty ring stored _tail before
+        // it, so a fresh _head never pairs with a stale _tail (the reverse reads as empty)
+        const uint64_t head = _head.load(std::memory_order_acquire);
+        uint64_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail >= head) return false;
+        size_t off = static_cast<size_t>(tail & (_cap - 1));
+        uint32_t n = read_len(off);
+        if (n == kWrapMarker) {
+            tail += _cap - off;
+            _tail.store(tail, std::memory_order_release);
+            off = 0;
+            n = read_len(0);
+        }
+        data = &_buf[off + sizeof(uint32_t)];
+        len = n;
+        return true;
+    }
+
+    // Consumer side. Drops the message last returned by peek().
+    void pop() {
+        const uint64_t tail = _tail.load(std::memory_order_relaxed);
+        const size_t off = static_cast<size_t>(tail & (_cap - 1));
+        _tail.store(tail + record_size(read_len(off)), std::memory_order_release);
+    }
+
+    bool empty() const {
+        const uint64_t head = _head.load(std::memory_order_acquire);
+        return _tail.load(std::memory_order_acquire) >= head;
+    }
+
+private:
+    static constexpr uint32_t kWrapMarker = 0xFFFFFFFFu;
+
+    static size_t record_size(size_t len) {
+        return sizeof(uint32_t) + ((len + 3) & ~size_t(3));
+    }
+    void write_len(size_t off, uint32_t n) { std::memcpy(&_buf[off], &n, sizeof(n)); }
+    uint32_t read_len(size_t off) const {
+        uint32_t n;
+        std::memcpy(&n, &_buf[off], sizeof(n));
+        return n;
+    }
+
+    size_t _cap = 0;
+    std::unique_ptr<uint8_t[]> _buf;
+    alignas(64) std::atomic<uint64_t> _head{0};  // written by the producer only
+    alignas(64) std::atomic<uint64_t> _tail{0};  // written by the consumer only
+};
+
+} // namespace ubicoders_zenoh
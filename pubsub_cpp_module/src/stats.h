@@ -0,0 +1,186 @@
+// stats.h
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace ubicoders_zenoh {
+
+// Log2-bucketed duration histogram. Bucket i counts samples in [2^i, 2^(i+1)) ns.
+// Recording is a handful of relaxed atomic adds, cheap enough to leave on under load.
+class LatencyHistogram {
+public:
+    static constexpr int kBuckets = 40;  // up to ~18 minutes
+
+    struct Snapshot {
+        uint64_t count = 0;
+        uint64_t sum_ns = 0;
+        uint64_t max_ns = 0;
+        uint64_t buckets[kBuckets] = {};
+
+        uint64_t mean_ns() const { return count ? sum_ns / count : 0; }
+        // Upper bound of the bucket holding the p-th quantile (0 < p <= 1), capped at max.
+        uint64_t percentile_ns(double p) const {
+            if (!count) return 0;
+            const uint64_t rank = static_cast<uint64_t>(p * count + 0.5);
+            uint64_t seen = 0;
+            for (int i = 0; i < kBuckets; ++i) {
+                seen += buckets[i];
+                if (seen >= rank && seen) {
+                    const uint64_t upper = (i + 1 < 64) ? (uint64_t(1) << (i + 1)) - 1 : UINT64_MAX;
+                    return upper < max_ns ? upper : max_ns;
+                }
+            }
+            return max_ns;
+        }
+    };
+
+    void record(uint64_t ns) {
+        int b = 0;
+        for (uint64_t v = ns; v > 1 && b < kBuckets - 1; v >>= 1) ++b;
+        _buckets[b].fetch_add(1, std::memory_order_relaxed);
+        _count.fetch_add(1, std::memory_order_relaxed);
+        _sum.fetch_add(ns, std::memory_order_relaxed);
+        uint64_t prev = _max.load(std::memory_order_relaxed);
+        while (ns > prev && !_max.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) { }
+    }
+
+    void record(std::chrono::steady_clock::duration d) {
+        record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count()));
+    }
+
+    Snapshot snapshot() const {
+        Snapshot s;
+        s.count = _count.load(std::memory_order_relaxed);
+        s.sum_ns = _sum.load(std::memory_order_relaxed);
+        s.max_ns = _max.load(std::memory_order_relaxed);
+        for (int i = 0; i < kBuckets; ++i) s.buckets[i] = _buckets[i].load(std::memory_order_relaxed);
+        return s;
+    }
+
+private:
+    std::atomic<uint64_t> _buckets[kBuckets] = {};
+    std::atomic<uint64_t> _count{0};
+    std::atomic<uint64_t> _sum{0};
+    std::atomic<uint64_t> _max{0};
+};
+
+enum class EndpointKind { Publisher = 0, Subscriber = 1, Server = 2, Querier = 3 };
+
+// Point-in-time copy of one endpoint's counters (see Node::stats()).
+struct EndpointStatsSnapshot {
+    std::string key;
+    EndpointKind kind = EndpointKind::Publisher;
+    uint64_t messages = 0;   // published / delivered samples, queries received or sent
+    uint64_t bytes = 0;      // payload bytes of the above
+    uint64_t errors = 0;     // failed puts, throwing callbacks, error replies
+    uint64_t timeouts = 0;   // deferred queries that hit their deadline, gets with no reply
+    uint64_t dropped = 0;    // samples a bounded subscription had no room for, shed queries
+    uint64_t cache_hits = 0; // queries answered from a server's reply cache or a publisher's last value
+    // Subscribers: callback time. Servers: handler start to reply (deferred: arrival to
+    // reply). Queriers: get to done.
+    LatencyHistogram::Snapshot latency;
+    // Pooled servers only: arrival to handler start
+    LatencyHistogram::Snapshot queue_wait;
+    // Compressing publishers / subscribers receiving compressed payloads
+    uint64_t compressed = 0;             // payloads that went over the wire compressed
+    uint64_t compressed_raw_bytes = 0;   // their size before compression
+    uint64_t compressed_wire_bytes = 0;  // and after
+    LatencyHistogram::Snapshot codec_time;  // per compression attempt / decompression
+    // Delta-mode publishers / subscribers decoding delta streams
+    uint64_t keyframes = 0;          // full payloads sent / received
+    uint64_t deltas = 0;             // deltas sent / applied
+    uint64_t delta_raw_bytes = 0;    // full size of the payloads the deltas stand for
+    uint64_t delta_wire_bytes = 0;   // size of the deltas themselves (before compression)
+    uint64_t keyframe_requests = 0;  // asked for after a gap / served
+    // Subscribers of stamping publishers (see PublisherOptions::stamp)
+    LatencyHistogram::Snapshot transit;  // source timestamp to arrival, across clocks
+    uint64_t gaps = 0;       // sequence numbers not seen: lost payloads, net of those that came late
+    uint64_t reordered = 0;  // payloads older than one already seen (repeats are not counted)
+
+    // Raw over wire size of the compressed payloads (0 when there were none)
+    double compression_ratio() const {
+        return compressed_wire_bytes ? double(compressed_raw_bytes) / double(compressed_wire_bytes) : 0.0;
+    }
+    // Full over encoded size of the delta-coded payloads (0 when there were none)
+    double delta_ratio() const {
+        return delta_wire_bytes ? double(delta_raw_bytes) / double(delta_wire_bytes) : 0.0;
+    }
+};
+
+// Live counters for one publisher, subscriber or server. Shared with the hot path,
+// which only ever does relaxed atomic adds on it.
+struct EndpointStats {
+    EndpointStats(std::string k, EndpointKind kd) : key(std::move(k)), kind(kd) {}
+
+    const std::string key;
+    const EndpointKind kind;
+    std::atomic<uint64_t> messages{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> errors{0};
+    std::atomic<uint64_t> timeouts{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> cache_hits{0};
+    LatencyHistogram latency;
+    LatencyHistogram queue_wait;
+    std::atomic<uint64_t> compressed{0};
+    std::atomic<uint64_t> compressed_raw_bytes{0};
+    std::atomic<uint64_t> compressed_wire_bytes{0};
+    LatencyHistogram codec_time;
+    std::atomic<uint64_t> keyframes{0};
+    std::atomic<uint64_t> deltas{0};
+    std::atomic<uint64_t> delta_raw_bytes{0};
+    std::atomic<uint64_t> delta_wire_bytes{0};
+    std::atomic<uint64_t> keyframe_requests{0};
+    LatencyHistogram transit;
+    std::atomic<uint64_t> gaps{0};
+    std::atomic<uint64_t> reordered{0};
+
+    void count(size_t n) {
+        messages.fetch_add(1, std::memory_order_relaxed);
+        bytes.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    void count_compressed(size_t raw, size_t wire) {
+        compressed.fetch_add(1, std::memory_order_relaxed);
+        compressed_raw_bytes.fetch_add(raw, std::memory_order_relaxed);
+        compressed_wire_bytes.fetch_add(wire, std::memory_order_relaxed);
+    }
+
+    void count_delta(size_t raw, size_t wire) {
+        deltas.fetch_add(1, std::memory_order_relaxed);
+        delta_raw_bytes.fetch_add(raw, std::memory_order_relaxed);
+        delta_wire_bytes.fetch_add(wire, std::memory_order_relaxed);
+    }
+
+    EndpointStatsSnapshot snapshot() const {
+        EndpointStatsSnapshot s;
+        s.key = key;
+        s.kind = kind;
+        s.messages = messages.load(std::memory_order_relaxed);
+        s.bytes = bytes.load(std::memory_order_relaxed);
+        s.errors = errors.load(std::memory_order_relaxed);
+        s.timeouts = timeouts.load(std::memory_order_relaxed);
+        s.dropped = dropped.load(std::memory_order_relaxed);
+        s.cache_hits = cache_hits.load(std::memory_order_relaxed);
+        s.latency = latency.snapshot();
+        s.queue_wait = queue_wait.snapshot();
+        s.compressed = compressed.load(std::memory_order_relaxed);
+        s.compressed_raw_bytes = compressed_raw_bytes.load(std::memory_order_relaxed);
+        s.compressed_wire_bytes = compressed_wire_bytes.load(std::memory_order_relaxed);
+        s.codec_time = codec_time.snapshot();
+        s.keyframes = keyframes.load(std::memory_order_relaxed);
+        s.deltas = deltas.load(std::memory_order_relaxed);
+        s.delta_raw_bytes = delta_raw_bytes.load(std::memory_order_relaxed);
+        s.delta_wire_bytes = delta_wire_bytes.load(std::memory_order_relaxed);
+        s.keyframe_requests = keyframe_requests.load(std::memory_order_relaxed);
+        s.transit = transit.snapshot();
+        s.gaps = gaps.load(std::memory_order_relaxed);
+        s.reordered = reordered.load(std::memory_order_relaxed);
+        return s;
+    }
+};
+
+} // namespace ubicoders_zenoh
@@ -16,8 +16,11 @@ void message_callback(const char* key, const uint8_t* data, int32_t len, void* u
     std::cout << std::dec << std::endl;
 }
 
-int main() {
-    ZU_NodeHandle node = ZU_CreateNode("subscriber_node");
+int main(int argc, char** argv) {
+    // --shm: exchange payloads with same-host peers through shared memory
+    ZU_NodeOptions options = {};
+    options.shared_memory = (argc > 1 && std::string(argv[1]) == "--shm") ? 1 : 0;
+    ZU_NodeHandle node = ZU_CreateNodeWithOptions("subscriber_node", &options);
     const char* key = "demo/example/bytes";
 
     ZU_CreateSubscriber(node, key, message_callback, nullptr);
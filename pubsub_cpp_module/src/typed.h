@@ -0,0 +1,117 @@
+// typed.h
+#pragma once
+
+#include "node.h"
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace ubicoders_zenoh {
+
+// Wire format of a typed topic. Specialize Codec<T> for custom types with:
+//   static size_t size(const T& v);                  // encoded size in bytes
+//   static void   encode(const T& v, uint8_t* out);  // writes exactly size(v) bytes
+//   static bool   decode(BytesView in, T& out);      // false rejects the sample
+template <class T, class Enable = void>
+struct Codec {
+    static_assert(sizeof(T) == 0,
+                  "no Codec<T>: T is not trivially copyable, specialize ubicoders_zenoh::Codec<T>");
+};
+
+// Trivially copyable types travel as their raw bytes (same layout on both ends)
+template <class T>
+struct Codec<T, std::enable_if_t<std::is_trivially_copyable<T>::value>> {
+    static size_t size(const T&) { return sizeof(T); }
+    static void encode(const T& v, uint8_t* out) { std::memcpy(out, &v, sizeof(T)); }
+    static bool decode(BytesView in, T& out) {
+        if (in.size != sizeof(T)) return false;
+        std::memcpy(&out, in.data, sizeof(T));
+        return true;
+    }
+};
+
+template <>
+struct Codec<std::string> {
+    static size_t size(const std::string& v) { return v.size(); }
+    static void encode(const std::string& v, uint8_t* out) { if (!v.empty()) std::memcpy(out, v.data(), v.size()); }
+    static bool decode(BytesView in, std::string& out) {
+        out.assign(reinterpret_cast<const char*>(in.data), in.size);
+        return true;
+    }
+};
+
+// Packed arrays of trivially copyable elements
+template <class U>
+struct Codec<std::vector<U>, std::enable_if_t<std::is_trivially_copyable<U>::value>> {
+    static size_t size(const std::vector<U>& v) { return v.size() * sizeof(U); }
+    static void encode(const std::vector<U>& v, uint8_t* out) { if (!v.empty()) std::memcpy(out, v.data(), size(v)); }
+    static bool decode(BytesView in, std::vector<U>& out) {
+        if (in.size % sizeof(U)) return false;
+        out.resize(in.size / sizeof(U));
+        if (in.size) std::memcpy(out.data(), in.data, in.size);
+        return true;
+    }
+};
+
+// Publisher of T values. Each value is encoded straight into the buffer handed to zenoh
+// (one allocation, no intermediate vector, no second copy). Cheap to copy and share.
+template <class T, class C = Codec<T>>
+class TypedPublisher {
+public:
+    TypedPublisher(Node& node, const std::string& key) : _pub(node.declare_publisher(key)) {}
+    explicit TypedPublisher(std::shared_ptr<PublisherHandle> pub) : _pub(std::move(pub)) {}
+
+    const std::string& key() const { return _pub->key(); }
+    const std::shared_ptr<PublisherHandle>& handle() const { return _pub; }
+
+    void publish(const T& value) const {
+        std::vector<uint8_t> buf(C::size(value));
+        C::encode(value, buf.data());
+        _pub->publish(std::move(buf));
+    }
+
+private:
+    std::shared_ptr<PublisherHandle> _pub;
+};
+
+// Subscription delivering decoded T values. Fixed-size values are decoded on the stack
+// straight from the zenoh payload view; nothing is allocated per sample.
+// Samples the codec rejects (e.g. wrong size) are skipped and counted.
+template <class T, class C = Codec<T>>
+class TypedSubscriber {
+public:
+    using Callback = std::function<void(const std::string& key, const T& value)>;
+
+    // Returns nullptr if `key` already has a subscriber. The subscription lives until
+    // Node::remove_subscriber(key), independently of the returned object.
+    static std::shared_ptr<TypedSubscriber> create(Node& node, const std::string& key, Callback cb) {
+        std::shared_ptr<TypedSubscriber> sub(new TypedSubscriber(std::move(cb)));
+        const bool created = node.create_view_subscriber(key, [sub](const std::string& k, BytesView payload) {
+            sub->deliver(k, payload);
+        });
+        return created ? sub : nullptr;
+    }
+
+    uint64_t rejected() const { return _rejected.load(std::memory_order_relaxed); }
+
+private:
+    explicit TypedSubscriber(Callback cb) : _cb(std::move(cb)) {}
+
+    void deliver(const std::string& key, BytesView payload) {
+        T value{};
+        if (!C::decode(payload, value)) {
+            _rejected.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        _cb(key, value);
+    }
+
+    Callback _cb;
+    std::atomic<uint64_t> _rejected{0};
+};
+
+} // namespace ubicoders_zenoh
@@ -4,55 +4,180 @@
 #include <atomic>
 #include <mutex>
 #include <unordered_map>
+#include <deque>
 #include <memory>
 #include <vector>
 #include <string>
 #include "node.h"
-#include <condition_variable>
+#include "handle_table.h"
 #include <chrono>
+#include <algorithm>
+#include <cstring>
 
 using ubicoders_zenoh::Node;
+using ubicoders_zenoh::PublisherHandle;
+using ubicoders_zenoh::PolledSubscription;
 
 namespace {
-std::atomic<uint64_t> g_next_id{1};
+// Reply events of a node's ZU_Get calls, waiting for ZU_PollReplies. Shared with the
+// zenoh reply closures so gets still in flight cannot outlive it.
+struct ReplyEvent {
+    uint64_t request_id;
+    int32_t status;
+    std::vector<uint8_t> payload;
+};
+
+struct ReplyInbox {
+    std::mutex mx;
+    std::deque<ReplyEvent> events;
+    std::atomic<uint64_t> next_id{1};
+
+    void push(uint64_t id, int32_t status, std::vector<uint8_t>&& payload) {
+        std::lock_guard<std::mutex> lk(mx);
+        events.push_back(ReplyEvent{id, status, std::move(payload)});
+    }
+};
 
+// Everything the C API keeps per node. Pending query state lives inside the Node itself.
 struct NodeEntry {
     std::unique_ptr<Node> node;
+    std::shared_ptr<ReplyInbox> replies = std::make_shared<ReplyInbox>();
+};
+
+// Heap cell behind a ZU_PublisherHandle
+struct PublisherEntry {
+    std::shared_ptr<PublisherHandle> pub;
 };
 
-std::mutex g_mx;
-std::unordered_map<uint64_t, NodeEntry> g_nodes;
+// Heap cell behind a ZU_SubscriberHandle
+struct PolledEntry {
+    ZU_NodeHandle node = 0;
+    std::string key;
+    std::shared_ptr<PolledSubscription> sub;
+};
 
-Node* get_node(ZU_NodeHandle h) {
-    if (h == 0) return nullptr;
-    std::lock_guard<std::mutex> lk(g_mx);
-    auto it = g_nodes.find(h);
-    return (it == g_nodes.end()) ? nullptr : it->second.node.get();
+constexpr size_t kMaxNodes      = 1024;
+constexpr size_t kMaxPublishers = 4096;
+constexpr size_t kMaxPolled     = 4096;
+
+// Slots hold shared entries: a call copies its entry out and drops the slot pin at once, so
+// remove() never waits on a call that blocks (undeclare, shutdown, a local put running
+// subscribers inline). A ZU_DestroyNode from one of the node's own callbacks therefore
+// returns at once; the node is torn down when the last in-flight call lets go of it.
+using NodeTable      = ubicoders_zenoh::HandleTable<std::shared_ptr<NodeEntry>, kMaxNodes>;
+using PublisherTable = ubicoders_zenoh::HandleTable<std::shared_ptr<PublisherEntry>, kMaxPublishers>;
+using PolledTable    = ubicoders_zenoh::HandleTable<std::shared_ptr<PolledEntry>, kMaxPolled>;
+
+NodeTable      g_nodes;
+PublisherTable g_publishers;
+PolledTable    g_polled;
+
+template <class T, size_t N>
+uint64_t insert_entry(ubicoders_zenoh::HandleTable<std::shared_ptr<T>, N>& table, std::unique_ptr<T> entry) {
+    return table.insert(std::make_unique<std::shared_ptr<T>>(std::move(entry)));
 }
 
-// Per-server registration (per node + key)
-struct ServerCfg {
-    ZU_QueryCallback cb = nullptr;
-    void* user = nullptr;
-    int timeout_ms = 3000;
-};
+template <class T, size_t N>
+std::shared_ptr<T> find_entry(const ubicoders_zenoh::HandleTable<std::shared_ptr<T>, N>& table, uint64_t h) {
+    auto ref = table.lookup(h);
+    return ref ? *ref : nullptr;
+}
 
-// One latch per request (Unity will complete/fail it)
-struct Pending {
-    std::mutex mtx;
-    std::condition_variable cv;
-    bool done = false;
-    bool ok = false;
-    std::vector<uint8_t> reply;
-    std::string err;
-};
+std::shared_ptr<NodeEntry> get_node(ZU_NodeHandle h) {
+    return find_entry(g_nodes, h);
+}
+
+std::shared_ptr<PublisherEntry> get_publisher(ZU_PublisherHandle h) {
+    return find_entry(g_publishers, h);
+}
+
+// A polled handle is only honoured together with the node it was created on
+std::shared_ptr<PolledEntry> get_polled(ZU_NodeHandle node, ZU_SubscriberHandle h) {
+    auto pe = find_entry(g_polled, h);
+    if (pe && pe->node != node) return nullptr;
+    return pe;
+}
+
+ubicoders_zenoh::DispatchOptions to_dispatch_options(int32_t capacity, int32_t overflow) {
+    ubicoders_zenoh::DispatchOptions o;
+    if (capacity > 0) o.capacity = static_cast<size_t>(capacity);
+    if (overflow == ZU_OVERFLOW_DROP_NEWEST) o.overflow = ubicoders_zenoh::OverflowPolicy::DropNewest;
+    else if (overflow == ZU_OVERFLOW_BLOCK) o.overflow = ubicoders_zenoh::OverflowPolicy::Block;
+    return o;
+}
+
+ubicoders_zenoh::SubscriberOptions to_subscriber_options(const ZU_SubscriberOptions* options) {
+    ubicoders_zenoh::SubscriberOptions o;
+    if (options) {
+        o.fetch_last_value = options->fetch_last_value != 0;
+        if (options->fetch_timeout_ms > 0) o.fetch_timeout = std::chrono::milliseconds(options->fetch_timeout_ms);
+        if (options->max_sources > 0) o.max_sources = static_cast<size_t>(options->max_sources);
+    }
+    return o;
+}
+
+ubicoders_zenoh::NodeOptions to_node_options(const ZU_NodeOptions* options) {
+    ubicoders_zenoh::NodeOptions opts;
+    if (options) {
+        opts.shared_memory = options->shared_memory != 0;
+        if (options->shm_threshold > 0) opts.shm_threshold = static_cast<size_t>(options->shm_threshold);
+        if (options->shm_pool_bytes > 0) opts.shm_pool_bytes = static_cast<size_t>(options->shm_pool_bytes);
+        if (options->dispatch_threads > 0) opts.dispatch_threads = static_cast<size_t>(options->dispatch_threads);
+        opts.dispatch = to_dispatch_options(options->dispatch_capacity, options->dispatch_overflow);
+        opts.share_session = options->private_session == 0;
+    }
+    return opts;
+}
 
-// node -> (key -> cfg)
-static std::unordered_map<uint64_t, std::unordered_map<std::string, ServerCfg>> g_servers;
-// node -> (request_id -> pending)
-static std::unordered_map<uint64_t, std::unordered_map<uint64_t, std::shared_ptr<Pending>>> g_pending;
+// "tcp/a:7447, tcp/b:7447" -> {"tcp/a:7447", "tcp/b:7447"}
+std::vector<std::string> split_endpoints(const char* list) {
+    std::vector<std::string> out;
+    if (!list) return out;
+    std::string cur;
+    for (const char* p = list;; ++p) {
+        if (*p == ',' || *p == ';' || *p == '\0') {
+            const size_t b = cur.find_first_not_of(" \t");
+            if (b != std::string::npos) out.push_back(cur.substr(b, cur.find_last_not_of(" \t") - b + 1));
+            cur.clear();
+            if (*p == '\0') break;
+        } else {
+            cur += *p;
+        }
+    }
+    return out;
+}
 
+int32_t declare_querier(ZU_NodeHandle node, const char* key, int32_t timeout_ms, bool streaming) {
+    if (!key) return 0;
+    if (auto e = get_node(node)) {
+        try {
+            e->node->declare_querier(key, std::chrono::milliseconds(timeout_ms > 0 ? timeout_ms : 3000),
+                                     streaming);
+            return 1;
+        } catch (...) {}
+    }
+    return 0;
+}
 
+// Replies of both kinds of get land in the node's inbox for ZU_PollReplies
+uint64_t send_get(ZU_NodeHandle node, const char* key, const char* parameters,
+                  const uint8_t* payload, int32_t len, bool streaming) {
+    if (!key || len < 0 || (!payload && len > 0)) return 0;
+    if (auto e = get_node(node)) {
+        try {
+            auto inbox = e->replies;
+            const uint64_t id = inbox->next_id.fetch_add(1, std::memory_order_relaxed);
+            auto querier = e->node->declare_querier(key, std::chrono::milliseconds(3000), streaming);
+            querier->get(parameters ? parameters : "", payload, static_cast<size_t>(len),
+                [inbox, id](bool ok, const std::string&, ubicoders_zenoh::BytesView v) {
+                    inbox->push(id, ok ? ZU_REPLY_OK : ZU_REPLY_ERROR, v.to_vector());
+                },
+                [inbox, id]() { inbox->push(id, ZU_REPLY_DONE, {}); });
+            return id;
+        } catch (...) {}
+    }
+    return 0;
+}
 
 } // namespace
 
@@ -60,50 +185,78 @@ extern "C" {
 
 ZU_NodeHandle ZU_CreateNode(const char* name) {
     try {
-        auto nid = g_next_id.fetch_add(1, std::memory_order_relaxed);
-        auto n = std::make_unique<Node>(name ? std::string(name) : std::string());
-        std::lock_guard<std::mutex> lk(g_mx);
-        g_nodes.emplace(nid, NodeEntry{std::move(n)});
-        return nid;
+        auto e = std::make_unique<NodeEntry>();
+        e->node = std::make_unique<Node>(name ? std::string(name) : std::string());
+        return insert_entry(g_nodes, std::move(e));  // 0 when the table is full
     } catch (...) { return 0; }
 }
 
-void ZU_DestroyNode(ZU_NodeHandle node) {
-    std::unique_ptr<Node> owned;
-    {
-        std::lock_guard<std::mutex> lk(g_mx);
-        auto it = g_nodes.find(node);
-        if (it != g_nodes.end()) {
-            owned = std::move(it->second.node);
-            g_nodes.erase(it);
+ZU_NodeHandle ZU_CreateNodeWithOptions(const char* name, const ZU_NodeOptions* options) {
+    try {
+        auto e = std::make_unique<NodeEntry>();
+        e->node = std::make_unique<Node>(name ? std::string(name) : std::string(), to_node_options(options));
+        return insert_entry(g_nodes, std::move(e));
+    } catch (...) { return 0; }
+}
+
+ZU_NodeHandle ZU_CreateNodeWithConfig(const char* name, const char* config, int32_t preset,
+                                      const char* connect, const char* listen,
+                                      const ZU_NodeOptions* options) {
+    try {
+        ubicoders_zenoh::NodeOptions opts = to_node_options(options);
+        if (config && *config) {
+            const char* p = config;
+            while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') ++p;
+            if (*p == '{') opts.config_json = config;
+            else opts.config_file = config;
         }
-    }
-    // dtor runs outside lock
+        switch (preset) {
+        case ZU_PRESET_LOOPBACK:      opts.preset = ubicoders_zenoh::SessionPreset::Loopback; break;
+        case ZU_PRESET_FIXED_CONNECT: opts.preset = ubicoders_zenoh::SessionPreset::FixedConnect; break;
+        case ZU_PRESET_NO_SCOUTING:   opts.preset = ubicoders_zenoh::SessionPreset::NoScouting; break;
+        default: break;
+        }
+        opts.connect = split_endpoints(connect);
+        opts.listen = split_endpoints(listen);
+        auto e = std::make_unique<NodeEntry>();
+        e->node = std::make_unique<Node>(name ? std::string(name) : std::string(), opts);
+        return insert_entry(g_nodes, std::move(e));
+    } catch (...) { return 0; }
+}
+
+int32_t ZU_IsSharedMemory(ZU_NodeHandle node) {
+    auto e = get_node(node);
+    return (e && e->node->shared_memory()) ? 1 : 0;
+}
+
+void ZU_DestroyNode(ZU_NodeHandle node) {
+    // Invalidates the handle; the node itself goes with the last in-flight call on it
+    auto owned = g_nodes.remove(node);
 }
 
 void ZU_ShutdownNode(ZU_NodeHandle node) {
-    if (auto* n = get_node(node)) {
-        n->shutdown();
+    if (auto e = get_node(node)) {
+        e->node->shutdown();
     }
 }
 
 // ---- Publisher API ----
 int32_t ZU_HasPublisher(ZU_NodeHandle node, const char* key) {
-    if (auto* n = get_node(node)) return n->has_publisher(key ? key : "");
+    if (auto e = get_node(node)) return e->node->has_publisher(key ? key : "");
     return 0;
 }
 
 int32_t ZU_CreatePublisher(ZU_NodeHandle node, const char* key) {
-    if (auto* n = get_node(node)) {
-        try { n->create_publisher(key ? key : ""); return 1; }
+    if (auto e = get_node(node)) {
+        try { e->node->create_publisher(key ? key : ""); return 1; }
         catch (...) { }
     }
     return 0;
 }
 
 int32_t ZU_RemovePublisher(ZU_NodeHandle node, const char* key) {
-    if (auto* n = get_node(node)) {
-        try { n->remove_publisher(key ? key : ""); return 1; }
+    if (auto e = get_node(node)) {
+        try { e->node->remove_publisher(key ? key : ""); return 1; }
         catch (...) { }
     }
     return 0;
@@ -112,50 +265,280 @@ int32_t ZU_RemovePublisher(ZU_NodeHandle node, const char* key) {
 int32_t ZU_Publish(ZU_NodeHandle node, const char* key,
                    const uint8_t* data, int32_t len) {
     if (!data || len < 0) return 0;
-    if (auto* n = get_node(node)) {
+    if (auto e = get_node(node)) {
         try {
-            std::vector<uint8_t> buf(data, data + len);
-            n->publish(key ? key : "", buf);
+            e->node->publish(key ? key : "", data, static_cast<size_t>(len));
             return 1;
         } catch (...) { }
     }
     return 0;
 }
 
+int32_t ZU_PublishBorrowed(ZU_NodeHandle node, const char* key,
+                           const uint8_t* data, int32_t len,
+                           ZU_ReleaseCallback release, void* user_data) {
+    auto e = get_node(node);
+    if (!e || !data || len < 0) {
+        if (release) release(data, user_data);
+        return 0;
+    }
+    try {
+        // Once publish_borrowed is entered, zenoh owns the release
+        e->node->publish_borrowed(key ? key : "", data, static_cast<size_t>(len),
+            [release, user_data](const uint8_t* p) {
+                if (release) release(p, user_data);
+            });
+        return 1;
+    } catch (...) { }
+    return 0;
+}
+
+ZU_PublisherHandle ZU_DeclarePublisher(ZU_NodeHandle node, const char* key) {
+    return ZU_DeclarePublisherWithOptions(node, key, nullptr);
+}
+
+ZU_PublisherHandle ZU_DeclarePublisherWithOptions(ZU_NodeHandle node, const char* key,
+                                                  const ZU_PublisherOptions* options) {
+    if (auto e = get_node(node)) {
+        try {
+            ubicoders_zenoh::PublisherOptions opts;
+            if (options && options->fragment_bytes > 0)
+                opts.fragment_bytes = static_cast<size_t>(options->fragment_bytes);
+            if (options && options->compression > 0) {
+                opts.compression.codec = static_cast<ubicoders_zenoh::Compression>(options->compression);
+                if (options->compression_threshold > 0)
+                    opts.compression.threshold = static_cast<size_t>(options->compression_threshold);
+                opts.compression.level = options->compression_level;
+            }
+            if (options && options->delta_keyframe_interval > 0)
+                opts.delta.keyframe_interval = static_cast<uint32_t>(options->delta_keyframe_interval);
+            if (options) opts.stamp = options->stamp != 0;
+            if (options) opts.last_value_cache = options->last_value_cache != 0;
+            auto pe = std::make_unique<PublisherEntry>();
+            pe->pub = e->node->declare_publisher(key ? key : "", opts);
+            return insert_entry(g_publishers, std::move(pe));
+        } catch (...) { }
+    }
+    return 0;
+}
+
+int32_t ZU_IsCompressionAvailable(int32_t codec) {
+    if (codec < ZU_COMPRESSION_NONE || codec > ZU_COMPRESSION_ZSTD) return 0;
+    return ubicoders_zenoh::compression_available(static_cast<ubicoders_zenoh::Compression>(codec)) ? 1 : 0;
+}
+
+void ZU_UndeclarePublisher(ZU_PublisherHandle pub) {
+    auto owned = g_publishers.remove(pub);
+}
+
+int32_t ZU_PublishTo(ZU_PublisherHandle pub, const uint8_t* data, int32_t len) {
+    if (!data || len < 0) return 0;
+    if (auto pe = get_publisher(pub)) {
+        try {
+            pe->pub->publish(data, static_cast<size_t>(len));
+            return 1;
+        } catch (...) { }
+    }
+    return 0;
+}
+
+int32_t ZU_PublishToBorrowed(ZU_PublisherHandle pub,
+                             const uint8_t* data, int32_t len,
+                             ZU_ReleaseCallback release, void* user_data) {
+    auto pe = get_publisher(pub);
+    if (!pe || !data || len < 0) {
+        if (release) release(data, user_data);
+        return 0;
+    }
+    try {
+        pe->pub->publish_borrowed(data, static_cast<size_t>(len),
+            [release, user_data](const uint8_t* p) {
+                if (release) release(p, user_data);
+            });
+        return 1;
+    } catch (...) { }
+    return 0;
+}
+
 // ---- Subscriber API ----
 int32_t ZU_HasSubscriber(ZU_NodeHandle node, const char* key) {
-    if (auto* n = get_node(node)) return n->has_subscriber(key ? key : "");
+    if (auto e = get_node(node)) return e->node->has_subscriber(key ? key : "");
     return 0;
 }
 
 int32_t ZU_CreateSubscriber(ZU_NodeHandle node, const char* key,
                             ZU_MessageCallback cb, void* user_data) {
+    return ZU_CreateSubscriberWithOptions(node, key, cb, user_data, nullptr);
+}
+
+int32_t ZU_CreateSubscriberWithOptions(ZU_NodeHandle node, const char* key,
+                                       ZU_MessageCallback cb, void* user_data,
+                                       const ZU_SubscriberOptions* options) {
     if (!cb) return 0;
-    if (auto* n = get_node(node)) {
+    if (auto e = get_node(node)) {
         try {
-            n->create_subscriber(key ? key : "",
+            e->node->create_view_subscriber(key ? key : "",
                 [cb, user_data](const std::string& k,
-                                const std::vector<uint8_t>& payload) {
-                    // Call out to C callback (background thread).
+                                ubicoders_zenoh::BytesView payload) {
+                    // Call out to C callback (background thread), straight over the payload.
                     cb(k.c_str(),
-                       payload.empty() ? nullptr : payload.data(),
-                       static_cast<int32_t>(payload.size()),
+                       payload.empty() ? nullptr : payload.data,
+                       static_cast<int32_t>(payload.size),
                        user_data);
-                });
+                },
+                to_subscriber_options(options));
             return 1;
         } catch (...) { }
     }
     return 0;
 }
 
+int32_t ZU_CreateDispatchedSubscriber(ZU_NodeHandle node, const char* key,
+                                      ZU_MessageCallback cb, void* user_data,
+                                      int32_t capacity, int32_t overflow) {
+    if (!cb) return 0;
+    if (auto e = get_node(node)) {
+        try {
+            auto q = e->node->create_dispatched_subscriber(key ? key : "",
+                [cb, user_data](const std::string& k, ubicoders_zenoh::BytesView payload) {
+                    cb(k.c_str(), payload.empty() ? nullptr : payload.data,
+                       static_cast<int32_t>(payload.size), user_data);
+                },
+                to_dispatch_options(capacity, overflow));
+            return q ? 1 : 0;
+        } catch (...) { }
+    }
+    return 0;
+}
+
+int32_t ZU_CreateKeyedSubscriber(ZU_NodeHandle node, const char* key,
+                                 ZU_KeyedMessageCallback cb, void* user_data) {
+    if (!cb) return 0;
+    if (auto e = get_node(node)) {
+        try {
+            const bool created = e->node->create_keyed_subscriber(key ? key : "",
+                [cb, user_data](const ubicoders_zenoh::InternedKey& k, ubicoders_zenoh::BytesView payload) {
+                    cb(k.id, k.name.c_str(), payload.empty() ? nullptr : payload.data,
+                       static_cast<int32_t>(payload.size), user_data);
+                });
+            return created ? 1 : 0;
+        } catch (...) { }
+    }
+    return 0;
+}
+
 int32_t ZU_RemoveSubscriber(ZU_NodeHandle node, const char* key) {
-    if (auto* n = get_node(node)) {
-        try { n->remove_subscriber(key ? key : ""); return 1; }
+    if (auto e = get_node(node)) {
+        try { e->node->remove_subscriber(key ? key : ""); return 1; }
+        catch (...) { }
+    }
+    return 0;
+}
+
+// ---- Interned keys ----
+uint32_t ZU_InternKey(const char* key) {
+    if (!key) return 0;
+    try {
+        auto k = ubicoders_zenoh::KeyTable::global().intern(key);
+        return k ? k->id : 0;
+    } catch (...) { }
+    return 0;
+}
+
+const char* ZU_GetKeyName(uint32_t key_id) {
+    auto k = ubicoders_zenoh::KeyTable::global().find(key_id);
+    return k ? k->name.c_str() : nullptr;
+}
+
+// ---- Latest-value Subscriber API ----
+int32_t ZU_CreateLatestSubscriber(ZU_NodeHandle node, const char* key) {
+    return ZU_CreateLatestSubscriberWithOptions(node, key, nullptr);
+}
+
+int32_t ZU_CreateLatestSubscriberWithOptions(ZU_NodeHandle node, const char* key,
+                                             const ZU_SubscriberOptions* options) {
+    if (auto e = get_node(node)) {
+        try { return e->node->create_latest_subscriber(key ? key : "", to_subscriber_options(options)) ? 1 : 0; }
         catch (...) { }
     }
     return 0;
 }
 
+int32_t ZU_GetLatest(ZU_NodeHandle node, const char* key,
+                     uint8_t* out_buf, int32_t out_cap, uint64_t* out_seq) {
+    if (out_seq) *out_seq = 0;
+    if (out_cap < 0 || (!out_buf && out_cap > 0)) return 0;
+    if (auto e = get_node(node)) {
+        try {
+            auto latest = e->node->latest_subscription(key ? key : "");
+            if (!latest) return 0;
+            size_t len = 0;
+            uint64_t seq = 0;
+            const bool ok = latest->read(out_buf, static_cast<size_t>(out_cap), len, &seq);
+            if (out_seq) *out_seq = seq;
+            if (seq == 0) return 0;
+            return ok ? static_cast<int32_t>(len) : -static_cast<int32_t>(len);
+        } catch (...) { }
+    }
+    return 0;
+}
+
+// ---- Polled Subscriber API ----
+ZU_SubscriberHandle ZU_CreatePolledSubscriber(ZU_NodeHandle node, const char* key,
+                                              int32_t capacity_bytes) {
+    return ZU_CreatePolledSubscriberWithOptions(node, key, capacity_bytes, nullptr);
+}
+
+ZU_SubscriberHandle ZU_CreatePolledSubscriberWithOptions(ZU_NodeHandle node, const char* key,
+                                                         int32_t capacity_bytes,
+                                                         const ZU_SubscriberOptions* options) {
+    if (auto e = get_node(node)) {
+        try {
+            auto pe = std::make_unique<PolledEntry>();
+            pe->node = node;
+            pe->key = key ? key : "";
+            pe->sub = e->node->create_polled_subscriber(
+                pe->key, capacity_bytes > 0 ? static_cast<size_t>(capacity_bytes) : (1u << 20),
+                to_subscriber_options(options));
+            if (!pe->sub) return 0;
+            const std::string k = pe->key;
+            const ZU_SubscriberHandle h = insert_entry(g_polled, std::move(pe));
+            if (!h) e->node->remove_subscriber(k);
+            return h;
+        } catch (...) { }
+    }
+    return 0;
+}
+
+int32_t ZU_RemovePolledSubscriber(ZU_NodeHandle node, ZU_SubscriberHandle sub) {
+    if (!get_polled(node, sub)) return 0;
+    auto owned = g_polled.remove(sub);
+    if (!owned) return 0;
+    if (auto e = get_node(node)) {
+        try { e->node->remove_subscriber((*owned)->key); }
+        catch (...) { }
+    }
+    return 1;
+}
+
+int32_t ZU_PollMessages(ZU_NodeHandle node, ZU_SubscriberHandle sub,
+                        uint8_t* out_buf, int32_t out_cap,
+                        int32_t* out_offsets, int32_t max_msgs) {
+    if (!out_offsets || max_msgs < 0 || out_cap < 0 || (!out_buf && out_cap > 0)) return 0;
+    auto pe = get_polled(node, sub);
+    if (!pe) return 0;
+    size_t needed = 0;
+    const size_t n = pe->sub->poll(out_buf, static_cast<size_t>(out_cap), out_offsets,
+                                   static_cast<size_t>(max_msgs), &needed);
+    if (n == 0 && needed) return -static_cast<int32_t>(needed);
+    return static_cast<int32_t>(n);
+}
+
+uint64_t ZU_GetPolledDropCount(ZU_NodeHandle node, ZU_SubscriberHandle sub) {
+    auto pe = get_polled(node, sub);
+    return pe ? pe->sub->dropped() : 0;
+}
+
 // ---- Query Server (Queryable) ----------------------------------------------
 int32_t ZU_CreateServer(ZU_NodeHandle node,
                         const char* key_expr,
@@ -163,91 +546,53 @@ int32_t ZU_CreateServer(ZU_NodeHandle node,
                         void* user_data,
                         int32_t timeout_ms)
 {
-    auto* n = get_node(node);
-    if (!n || !key_expr || !cb) return 0;
+    return ZU_CreateCachedServer(node, key_expr, cb, user_data, timeout_ms, 0, 0);
+}
 
-    // Save callback config
-    {
-        std::lock_guard<std::mutex> lk(g_mx);
-        g_servers[node][key_expr] = ServerCfg{cb, user_data, timeout_ms > 0 ? timeout_ms : 3000};
-    }
+int32_t ZU_CreateCachedServer(ZU_NodeHandle node,
+                              const char* key_expr,
+                              ZU_QueryCallback cb,
+                              void* user_data,
+                              int32_t timeout_ms,
+                              int32_t cache_ttl_ms,
+                              int64_t cache_max_bytes)
+{
+    auto e = get_node(node);
+    if (!e || !key_expr || !cb) return 0;
 
     try {
-        // Bridge Node::create_server to Unity async complete/fail
-        n->create_server(key_expr,
-            [node, key = std::string(key_expr)](const std::string& key_in,
-                                                const std::string& params,
-                                                const std::vector<uint8_t>& payload) -> std::vector<uint8_t>
+        ubicoders_zenoh::ReplyCacheOptions cache;
+        if (cache_ttl_ms > 0) cache.ttl = std::chrono::milliseconds(cache_ttl_ms);
+        if (cache_max_bytes > 0) cache.max_bytes = static_cast<size_t>(cache_max_bytes);
+
+        // Bridge to Unity: the query is parked in the node and the zenoh thread returns
+        // immediately; ZU_CompleteRequest / ZU_FailRequest answer it later.
+        e->node->create_deferred_server(key_expr,
+            [cb, user_data](uint64_t request_id,
+                            const std::string& key,
+                            const std::string& params,
+                            ubicoders_zenoh::BytesView payload)
             {
-                // Load cfg
-                ServerCfg cfg{};
-                {
-                    std::lock_guard<std::mutex> lk(g_mx);
-                    auto nit = g_servers.find(node);
-                    if (nit == g_servers.end()) throw std::runtime_error("server-not-found");
-                    auto sit = nit->second.find(key);
-                    if (sit == nit->second.end()) throw std::runtime_error("server-not-found");
-                    cfg = sit->second;
-                }
-
-                // Create pending entry
-                uint64_t id = g_next_id.fetch_add(1, std::memory_order_relaxed);
-                auto pend = std::make_shared<Pending>();
-                {
-                    std::lock_guard<std::mutex> lk(g_mx);
-                    g_pending[node][id] = pend;
-                }
-
                 // Fire Unity callback (background thread!)
-                const uint8_t* data = payload.empty() ? nullptr : payload.data();
-                cfg.cb(id, key.c_str(), data, static_cast<int32_t>(payload.size()),
-                       params.c_str(), cfg.user);
-
-                // Wait for Unity to complete or timeout
-                std::unique_lock<std::mutex> ul(pend->mtx);
-                if (!pend->cv.wait_for(
-                        ul,
-                        std::chrono::milliseconds(cfg.timeout_ms),
-                        [&]{ return pend->done; }))
-                {
-                    // Timeout → clean up and error
-                    {
-                        std::lock_guard<std::mutex> lk(g_mx);
-                        auto nit = g_pending.find(node);
-                        if (nit != g_pending.end()) nit->second.erase(id);
-                    }
-                    throw std::runtime_error("timeout");
-                }
-
-                // Completed → remove
-                {
-                    std::lock_guard<std::mutex> lk(g_mx);
-                    auto nit = g_pending.find(node);
-                    if (nit != g_pending.end()) nit->second.erase(id);
-                }
-
-                if (!pend->ok) throw std::runtime_error(pend->err.empty() ? "error" : pend->err);
-                return pend->reply; // Node::create_server will reply with these bytes
-            });
+                const uint8_t* data = payload.empty() ? nullptr : payload.data;
+                cb(request_id, key.c_str(), data, static_cast<int32_t>(payload.size),
+                   params.c_str(), user_data);
+            },
+            std::chrono::milliseconds(timeout_ms > 0 ? timeout_ms : 3000),
+            cache);
 
         return 1;
     } catch (...) {
-        std::lock_guard<std::mutex> lk(g_mx);
-        auto it = g_servers.find(node);
-        if (it != g_servers.end()) it->second.erase(key_expr);
         return 0;
     }
 }
 
 int32_t ZU_RemoveServer(ZU_NodeHandle node, const char* key_expr)
 {
-    auto* n = get_node(node);
-    if (!n || !key_expr) return 0;
+    auto e = get_node(node);
+    if (!e || !key_expr) return 0;
     try {
-        n->remove_server(key_expr);
-        std::lock_guard<std::mutex> lk(g_mx);
-        auto it = g_servers.find(node);
-        if (it != g_servers.end()) it->second.erase(key_expr);
+        e->node->remove_server(key_expr);
         return 1;
     } catch (...) { return 0; }
 }
@@ -255,45 +600,147 @@ int32_t ZU_RemoveServer(ZU_NodeHandle node, const char* key_expr)
 int32_t ZU_CompleteRequest(ZU_NodeHandle node, uint64_t request_id,
                            const uint8_t* bytes, int32_t len)
 {
-    std::shared_ptr<Pending> p;
-    {
-        std::lock_guard<std::mutex> lk(g_mx);
-        auto nit = g_pending.find(node);
-        if (nit == g_pending.end()) return 0;
-        auto pit = nit->second.find(request_id);
-        if (pit == nit->second.end()) return 0;
-        p = pit->second;
-    }
-    {
-        std::lock_guard<std::mutex> lk(p->mtx);
-        p->ok = true;
-        p->reply.assign(bytes ? bytes : nullptr,
-                        (bytes && len > 0) ? (bytes + len) : bytes);
-        p->done = true;
-    }
-    p->cv.notify_all();
-    return 1;
+    auto e = get_node(node);
+    if (!e || len < 0 || (!bytes && len > 0)) return 0;
+    try {
+        return e->node->complete_request(request_id, bytes, static_cast<size_t>(len)) ? 1 : 0;
+    } catch (...) { return 0; }
 }
 
 int32_t ZU_FailRequest(ZU_NodeHandle node, uint64_t request_id, const char* message)
 {
-    std::shared_ptr<Pending> p;
-    {
-        std::lock_guard<std::mutex> lk(g_mx);
-        auto nit = g_pending.find(node);
-        if (nit == g_pending.end()) return 0;
-        auto pit = nit->second.find(request_id);
-        if (pit == nit->second.end()) return 0;
-        p = pit->second;
+    auto e = get_node(node);
+    if (!e) return 0;
+    try {
+        return e->node->fail_request(request_id, message ? message : "") ? 1 : 0;
+    } catch (...) { return 0; }
+}
+
+int32_t ZU_ReplyPartial(ZU_NodeHandle node, uint64_t request_id,
+                        const uint8_t* bytes, int32_t len)
+{
+    auto e = get_node(node);
+    if (!e || len < 0 || (!bytes && len > 0)) return 0;
+    try {
+        return e->node->reply_partial(request_id, bytes, static_cast<size_t>(len)) ? 1 : 0;
+    } catch (...) { return 0; }
+}
+
+int32_t ZU_FinishRequest(ZU_NodeHandle node, uint64_t request_id)
+{
+    auto e = get_node(node);
+    if (!e) return 0;
+    try {
+        return e->node->finish_request(request_id) ? 1 : 0;
+    } catch (...) { return 0; }
+}
+
+// ---- Query Client (Querier) ------------------------------------------------
+int32_t ZU_DeclareQuerier(ZU_NodeHandle node, const char* key, int32_t timeout_ms) {
+    return declare_querier(node, key, timeout_ms, false);
+}
+
+int32_t ZU_DeclareStreamQuerier(ZU_NodeHandle node, const char* key, int32_t timeout_ms) {
+    return declare_querier(node, key, timeout_ms, true);
+}
+
+int32_t ZU_RemoveQuerier(ZU_NodeHandle node, const char* key) {
+    if (!key) return 0;
+    if (auto e = get_node(node)) {
+        try { e->node->remove_querier(key); return 1; } catch (...) {}
+    }
+    return 0;
+}
+
+uint64_t ZU_Get(ZU_NodeHandle node, const char* key, const char* parameters,
+                const uint8_t* payload, int32_t len) {
+    return send_get(node, key, parameters, payload, len, false);
+}
+
+uint64_t ZU_GetStream(ZU_NodeHandle node, const char* key, const char* parameters,
+                      const uint8_t* payload, int32_t len) {
+    return send_get(node, key, parameters, payload, len, true);
+}
+
+int32_t ZU_PollReplies(ZU_NodeHandle node, uint8_t* out_buf, int32_t out_cap,
+                       ZU_ReplyInfo* out_info, int32_t max_replies) {
+    if (out_cap < 0 || (!out_buf && out_cap > 0) || !out_info || max_replies <= 0) return 0;
+    if (auto e = get_node(node)) {
+        ReplyInbox& inbox = *e->replies;
+        std::lock_guard<std::mutex> lk(inbox.mx);
+        int32_t n = 0;
+        size_t used = 0;
+        while (n < max_replies && !inbox.events.empty()) {
+            ReplyEvent& ev = inbox.events.front();
+            const size_t sz = ev.payload.size();
+            if (used + sz > static_cast<size_t>(out_cap)) {
+                if (n == 0) return -static_cast<int32_t>(sz);
+                break;
+            }
+            if (sz) std::memcpy(out_buf + used, ev.payload.data(), sz);
+            out_info[n] = ZU_ReplyInfo{ev.request_id, ev.status, static_cast<int32_t>(used),
+                                       static_cast<int32_t>(sz), 0};
+            used += sz;
+            ++n;
+            inbox.events.pop_front();
+        }
+        return n;
     }
-    {
-        std::lock_guard<std::mutex> lk(p->mtx);
-        p->ok = false;
-        p->err = message ? message : "error";
-        p->done = true;
+    return 0;
+}
+
+int32_t ZU_GetStats(ZU_NodeHandle node, ZU_KeyStats* out, int32_t cap) {
+    if (auto e = get_node(node)) {
+        try {
+            const auto all = e->node->stats();
+            const size_t n = (out && cap > 0) ? std::min(all.size(), static_cast<size_t>(cap)) : 0;
+            for (size_t i = 0; i < n; ++i) {
+                const auto& s = all[i];
+                ZU_KeyStats& o = out[i];
+                std::memset(&o, 0, sizeof(o));
+                std::strncpy(o.key, s.key.c_str(), sizeof(o.key) - 1);
+                o.kind            = static_cast<int32_t>(s.kind);
+                o.messages        = s.messages;
+                o.bytes           = s.bytes;
+                o.errors          = s.errors;
+                o.timeouts        = s.timeouts;
+                o.dropped         = s.dropped;
+                o.latency_count   = s.latency.count;
+                o.latency_mean_ns = s.latency.mean_ns();
+                o.latency_p50_ns  = s.latency.percentile_ns(0.50);
+                o.latency_p90_ns  = s.latency.percentile_ns(0.90);
+                o.latency_p99_ns  = s.latency.percentile_ns(0.99);
+                o.latency_max_ns  = s.latency.max_ns;
+                o.queue_wait_count   = s.queue_wait.count;
+                o.queue_wait_mean_ns = s.queue_wait.mean_ns();
+                o.queue_wait_p50_ns  = s.queue_wait.percentile_ns(0.50);
+                o.queue_wait_p99_ns  = s.queue_wait.percentile_ns(0.99);
+                o.queue_wait_max_ns  = s.queue_wait.max_ns;
+                o.cache_hits         = s.cache_hits;
+                o.compressed            = s.compressed;
+                o.compressed_raw_bytes  = s.compressed_raw_bytes;
+                o.compressed_wire_bytes = s.compressed_wire_bytes;
+                o.codec_time_count      = s.codec_time.count;
+                o.codec_time_mean_ns    = s.codec_time.mean_ns();
+                o.codec_time_p99_ns     = s.codec_time.percentile_ns(0.99);
+                o.codec_time_max_ns     = s.codec_time.max_ns;
+                o.keyframes         = s.keyframes;
+                o.deltas            = s.deltas;
+                o.delta_raw_bytes   = s.delta_raw_bytes;
+                o.delta_wire_bytes  = s.delta_wire_bytes;
+                o.keyframe_requests = s.keyframe_requests;
+                o.transit_count   = s.transit.count;
+                o.transit_mean_ns = s.transit.mean_ns();
+                o.transit_p50_ns  = s.transit.percentile_ns(0.50);
+                o.transit_p99_ns  = s.transit.percentile_ns(0.99);
+                o.transit_max_ns  = s.transit.max_ns;
+                o.gaps            = s.gaps;
+                o.reordered       = s.reordered;
+            }
+            return static_cast<int32_t>(all.size());
+        } catch (...) {}
     }
-    p->cv.notify_all();
-    return 1;
+    return -1;
 }
 
 } // extern "C"
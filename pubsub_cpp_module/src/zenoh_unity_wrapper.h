@@ -21,10 +21,21 @@ extern "C" {
 #endif
 
 // Opaque handle to a Node instance.
-// 0 means failure / invalid handle.
+// 0 means failure / invalid handle. Handles are generation-checked: using one after
+// ZU_DestroyNode fails cleanly instead of touching freed memory.
 typedef uint64_t ZU_NodeHandle;
 
+// Opaque handle to a declared publisher (see ZU_DeclarePublisher).
+// 0 means failure / invalid handle.
+typedef uint64_t ZU_PublisherHandle;
+
+// Opaque handle to a polled subscription (see ZU_CreatePolledSubscriber).
+// 0 means failure / invalid handle.
+typedef uint64_t ZU_SubscriberHandle;
+
 // Subscription callback invoked from a background thread.
+// `data` points straight at the received payload (or a pooled copy if it arrived
+// fragmented) and is only valid until the callback returns.
 // NOTE: Do NOT touch UnityEngine APIs directly in this callback.
 // Forward the data to Unity's main thread (see C# wrapper below).
 typedef void (ZU_CALL *ZU_MessageCallback)(
@@ -33,8 +44,62 @@ typedef void (ZU_CALL *ZU_MessageCallback)(
     int32_t len,
     void* user_data);
 
+// Same, plus the interned id of `key` (see ZU_InternKey). The id and the `key` pointer stay
+// valid for the life of the process, so managed code can cache the decoded string by id
+// and skip marshalling the key on every sample. `key_id` is 0 if the key table is full;
+// only then is `key` valid just for the duration of the call.
+typedef void (ZU_CALL *ZU_KeyedMessageCallback)(
+    uint32_t key_id,
+    const char* key,
+    const uint8_t* data,
+    int32_t len,
+    void* user_data);
+
+// Releases a buffer handed to ZU_PublishBorrowed once the native side is done with it.
+// May be invoked from a background thread.
+typedef void (ZU_CALL *ZU_ReleaseCallback)(
+    const uint8_t* data,
+    void* user_data);
+
 // ---- Lifecycle --------------------------------------------------------------
+// Session settings for ZU_CreateNodeWithOptions. Zero-initialize, then set what you need.
+typedef struct ZU_NodeOptions {
+    int32_t  shared_memory;    // 1: same-host peers exchange payloads through shared memory
+    int32_t  shm_threshold;    // payloads smaller than this stay inline (<= 0 selects 4096)
+    uint64_t shm_pool_bytes;   // size of the publisher-side pool (0 selects 64 MiB)
+    int32_t  dispatch_threads; // > 0: subscriber callbacks run on this many native workers
+    int32_t  dispatch_capacity;  // samples queued per subscription (<= 0 selects 1024)
+    int32_t  dispatch_overflow;  // ZU_OVERFLOW_*
+    int32_t  private_session;  // 1: own zenoh session; 0: share one with same-config nodes
+} ZU_NodeOptions;
+
+// What a full dispatch queue does with the next sample
+#define ZU_OVERFLOW_DROP_OLDEST 0
+#define ZU_OVERFLOW_DROP_NEWEST 1
+#define ZU_OVERFLOW_BLOCK       2
+
+// Nodes opened with the same session settings share one zenoh session (threads, sockets,
+// discovery) unless ZU_NodeOptions::private_session is set; each keeps its own endpoints.
 ZU_API ZU_NodeHandle ZU_CreateNode(const char* name /* nullable */);
+ZU_API ZU_NodeHandle ZU_CreateNodeWithOptions(const char* name /* nullable */,
+                                              const ZU_NodeOptions* options /* nullable */);
+
+// Session presets for ZU_CreateNodeWithConfig; all but DEFAULT skip the scouting delay.
+#define ZU_PRESET_DEFAULT       0  // zenoh defaults: multicast scouting on the LAN
+#define ZU_PRESET_LOOPBACK      1  // this host only; connects to tcp/127.0.0.1:7447 unless `connect` is set
+#define ZU_PRESET_FIXED_CONNECT 2  // only the `connect` endpoints (required), no scouting
+#define ZU_PRESET_NO_SCOUTING   3  // no multicast or gossip scouting
+
+// `config` is a zenoh JSON5 config: inline if it starts with '{', otherwise a file path.
+// `connect` / `listen` are comma-separated endpoint lists ("tcp/10.0.0.5:7447").
+// All nullable. Returns 0 if the config cannot be read or the session fails to open.
+ZU_API ZU_NodeHandle ZU_CreateNodeWithConfig(const char* name, const char* config, int32_t preset,
+                                             const char* connect, const char* listen,
+                                             const ZU_NodeOptions* options);
+// 1 if the node actually runs in shared-memory mode (needs a zenoh build with SHM support)
+ZU_API int32_t       ZU_IsSharedMemory(ZU_NodeHandle node);
+// Never blocks on other calls, so it may be called from the node's own callbacks; calls
+// already in flight on the handle finish first, then the node is torn down.
 ZU_API void          ZU_DestroyNode(ZU_NodeHandle node);
 ZU_API void          ZU_ShutdownNode(ZU_NodeHandle node);
 
@@ -43,7 +108,57 @@ ZU_API int32_t ZU_HasPublisher(ZU_NodeHandle node, const char* key);
 ZU_API int32_t ZU_CreatePublisher(ZU_NodeHandle node, const char* key);
 ZU_API int32_t ZU_RemovePublisher(ZU_NodeHandle node, const char* key);
 ZU_API int32_t ZU_Publish(ZU_NodeHandle node, const char* key,
-                          const uint8_t* data, int32_t len);
+                          const uint8_t* data, int32_t len);   // copies `data` once
+// Zero-copy publish: `data` must stay valid (and pinned) until `release` is called.
+// `release` (nullable) is invoked exactly once, even when this call fails.
+ZU_API int32_t ZU_PublishBorrowed(ZU_NodeHandle node, const char* key,
+                                  const uint8_t* data, int32_t len,
+                                  ZU_ReleaseCallback release, void* user_data);
+
+// Pre-resolved publisher: ZU_PublishTo goes straight to the zenoh publisher with no
+// key hashing and no lock. The handle stays usable until ZU_UndeclarePublisher, even
+// across ZU_RemovePublisher; after ZU_DestroyNode publishing through it fails.
+// Stale handles are rejected the same way as stale node handles.
+ZU_API ZU_PublisherHandle ZU_DeclarePublisher(ZU_NodeHandle node, const char* key);
+
+// Per-publisher settings for ZU_DeclarePublisherWithOptions. Zero-initialize, then set what
+// you need. Settings only apply when the node has no publisher for `key` yet.
+typedef struct ZU_PublisherOptions {
+    // > 0: payloads larger than this are sent as fragments of this size and reassembled by
+    // the receiving node's subscribers into pooled buffers, so multi-MB payloads never need
+    // one giant allocation. Incomplete payloads are dropped after 2 s.
+    int32_t fragment_bytes;
+    // ZU_COMPRESSION_*: payloads of at least `compression_threshold` bytes (<= 0 selects 512)
+    // are compressed when that saves at least 10%; receiving subscribers decompress them.
+    // A codec missing from this build (see ZU_IsCompressionAvailable) sends raw bytes.
+    int32_t compression;
+    int32_t compression_threshold;
+    int32_t compression_level;  // 0: codec default
+    // > 0: sends deltas against the previous payload, with a full keyframe every this many
+    // samples (and whenever the payload size changes). Receiving subscribers rebuild the full
+    // payloads and request a keyframe after a lost sample.
+    int32_t delta_keyframe_interval;
+    // Non-zero: tags payloads with a sequence number and source timestamp, from which
+    // receiving subscribers report one-way latency, gaps and reordering (see ZU_KeyStats)
+    int32_t stamp;
+    // Non-zero: keeps the last payload for late joiners, served to subscribers created with
+    // ZU_SubscriberOptions::fetch_last_value. Implies `stamp`.
+    int32_t last_value_cache;
+} ZU_PublisherOptions;
+
+#define ZU_COMPRESSION_NONE 0
+#define ZU_COMPRESSION_LZ4  1
+#define ZU_COMPRESSION_ZSTD 2
+
+ZU_API int32_t ZU_IsCompressionAvailable(int32_t codec);
+
+ZU_API ZU_PublisherHandle ZU_DeclarePublisherWithOptions(ZU_NodeHandle node, const char* key,
+                                                         const ZU_PublisherOptions* options /* nullable */);
+ZU_API void               ZU_UndeclarePublisher(ZU_PublisherHandle pub);
+ZU_API int32_t ZU_PublishTo(ZU_PublisherHandle pub, const uint8_t* data, int32_t len);
+ZU_API int32_t ZU_PublishToBorrowed(ZU_PublisherHandle pub,
+                                    const uint8_t* data, int32_t len,
+                                    ZU_ReleaseCallback release, void* user_data);
 
 // ---- Subscriber API ---------------------------------------------------------
 ZU_API int32_t ZU_HasSubscriber(ZU_NodeHandle node, const char* key);
@@ -51,6 +166,73 @@ ZU_API int32_t ZU_CreateSubscriber(ZU_NodeHandle node, const char* key,
                                    ZU_MessageCallback cb, void* user_data);
 ZU_API int32_t ZU_RemoveSubscriber(ZU_NodeHandle node, const char* key);
 
+// Per-subscriber settings for the *WithOptions variants. Zero-initialize, then set what you need.
+typedef struct ZU_SubscriberOptions {
+    // Non-zero: right after subscribing, fetches the last value of every publisher on the key
+    // that keeps one (ZU_PublisherOptions::last_value_cache) and delivers it like a live
+    // sample, without duplicating what the live stream delivers
+    int32_t fetch_last_value;
+    int32_t fetch_timeout_ms;  // <= 0 selects 1000
+    // Publishers on the key tracked at once for delta decoding and gap counting; <= 0 selects 16
+    int32_t max_sources;
+} ZU_SubscriberOptions;
+
+ZU_API int32_t ZU_CreateSubscriberWithOptions(ZU_NodeHandle node, const char* key,
+                                              ZU_MessageCallback cb, void* user_data,
+                                              const ZU_SubscriberOptions* options /* nullable */);
+
+// Like ZU_CreateSubscriber, but `cb` runs on the node's dispatch workers, never on a zenoh
+// thread: in arrival order per key, keys in parallel, through a queue of `capacity` samples
+// (<= 0 selects 1024) that applies `overflow` (ZU_OVERFLOW_*) when full. Drops show up in
+// ZU_GetStats.
+ZU_API int32_t ZU_CreateDispatchedSubscriber(ZU_NodeHandle node, const char* key,
+                                             ZU_MessageCallback cb, void* user_data,
+                                             int32_t capacity, int32_t overflow);
+
+// Like ZU_CreateSubscriber, for wildcard subscriptions: `cb` also receives the key id.
+ZU_API int32_t ZU_CreateKeyedSubscriber(ZU_NodeHandle node, const char* key,
+                                        ZU_KeyedMessageCallback cb, void* user_data);
+
+// ---- Interned keys ----------------------------------------------------------
+// Process-wide: ids are shared by all nodes and never reused. Returns 0 on failure.
+ZU_API uint32_t ZU_InternKey(const char* key);
+// The key for `key_id`, or NULL if unknown. The pointer stays valid for the process.
+ZU_API const char* ZU_GetKeyName(uint32_t key_id);
+
+// ---- Latest-value (conflating) Subscriber API -------------------------------
+// Keeps only the newest sample for `key`; no callback and no per-sample queueing.
+ZU_API int32_t ZU_CreateLatestSubscriber(ZU_NodeHandle node, const char* key);
+ZU_API int32_t ZU_CreateLatestSubscriberWithOptions(ZU_NodeHandle node, const char* key,
+                                                    const ZU_SubscriberOptions* options /* nullable */);
+
+// Copies the newest sample into `out_buf`. Returns its length (0 if nothing has arrived
+// yet, check *out_seq), or -(its length) if `out_cap` is too small. `out_seq` (nullable)
+// receives the sample counter; an unchanged value means no new sample since last read.
+ZU_API int32_t ZU_GetLatest(ZU_NodeHandle node, const char* key,
+                            uint8_t* out_buf, int32_t out_cap, uint64_t* out_seq);
+
+// ---- Polled Subscriber API --------------------------------------------------
+// No background callback: samples are queued in a native ring of `capacity_bytes`
+// (<= 0 selects 1 MiB) and drained with ZU_PollMessages from the caller's thread,
+// typically once per frame. Samples arriving while the ring is full are dropped.
+ZU_API ZU_SubscriberHandle ZU_CreatePolledSubscriber(ZU_NodeHandle node, const char* key,
+                                                     int32_t capacity_bytes);
+ZU_API ZU_SubscriberHandle ZU_CreatePolledSubscriberWithOptions(ZU_NodeHandle node, const char* key,
+                                                                int32_t capacity_bytes,
+                                                                const ZU_SubscriberOptions* options /* nullable */);
+ZU_API int32_t ZU_RemovePolledSubscriber(ZU_NodeHandle node, ZU_SubscriberHandle sub);
+
+// Copies up to `max_msgs` messages back to back into `out_buf` (`out_cap` bytes).
+// Message i spans [out_offsets[i], out_offsets[i + 1]), so `out_offsets` must hold
+// max_msgs + 1 entries. Returns the number of messages copied; if the oldest message
+// alone is larger than `out_cap`, returns -(its size) and consumes nothing.
+ZU_API int32_t ZU_PollMessages(ZU_NodeHandle node, ZU_SubscriberHandle sub,
+                               uint8_t* out_buf, int32_t out_cap,
+                               int32_t* out_offsets, int32_t max_msgs);
+
+// Number of samples dropped so far because the ring was full.
+ZU_API uint64_t ZU_GetPolledDropCount(ZU_NodeHandle node, ZU_SubscriberHandle sub);
+
 // ---- Query Server (Queryable) ----------------------------------------------
 // Callback invoked on a background thread when a query arrives.
 // DO NOT touch Unity APIs here—queue to main thread and finish via ZU_CompleteRequest / ZU_FailRequest.
@@ -61,8 +243,9 @@ typedef void (ZU_CALL *ZU_QueryCallback)(
     const char* parameters,
     void* user_data);
 
-// Declare a server (queryable) for `key_expr`. The native side waits up to `timeout_ms`
-// for ZU_CompleteRequest / ZU_FailRequest. On timeout, the client gets an error.
+// Declare a server (queryable) for `key_expr`. The query is held as a deferred reply for up
+// to `timeout_ms` until ZU_CompleteRequest / ZU_FailRequest (callable from any thread);
+// no native thread blocks meanwhile. On timeout, the client gets an error.
 ZU_API int32_t ZU_CreateServer(
     ZU_NodeHandle node,
     const char* key_expr,
@@ -70,6 +253,19 @@ ZU_API int32_t ZU_CreateServer(
     void* user_data,
     int32_t timeout_ms /* e.g., 3000 */);
 
+// Same, for idempotent servers: a successful reply is kept for `cache_ttl_ms` (within a
+// budget of `cache_max_bytes` covering replies and their queries, <= 0 selects 16 MiB) and
+// served again to queries with the same key, parameters and payload without invoking `cb`.
+// Concurrent identical queries share one callback. cache_ttl_ms <= 0 behaves like ZU_CreateServer.
+ZU_API int32_t ZU_CreateCachedServer(
+    ZU_NodeHandle node,
+    const char* key_expr,
+    ZU_QueryCallback cb,
+    void* user_data,
+    int32_t timeout_ms,
+    int32_t cache_ttl_ms,
+    int64_t cache_max_bytes);
+
 ZU_API int32_t ZU_RemoveServer(ZU_NodeHandle node, const char* key_expr);
 
 // Finish a pending request successfully (send reply bytes).
@@ -85,6 +281,116 @@ ZU_API int32_t ZU_FailRequest(
     uint64_t request_id,
     const char* message);
 
+// Streamed replies: each ZU_ReplyPartial is sent as its own reply and the request stays
+// pending; ZU_CompleteRequest (a last reply), ZU_FailRequest or ZU_FinishRequest (no further
+// reply) end it. `timeout_ms` bounds the whole stream. Not available on cached servers.
+// Clients receive every part through ZU_GetStream.
+ZU_API int32_t ZU_ReplyPartial(
+    ZU_NodeHandle node,
+    uint64_t request_id,
+    const uint8_t* bytes,
+    int32_t len);
+
+ZU_API int32_t ZU_FinishRequest(ZU_NodeHandle node, uint64_t request_id);
+
+// ---- Query Client (Querier) ------------------------------------------------
+// Gets are asynchronous: ZU_Get returns right away with a request id, and the replies
+// are queued natively until drained with ZU_PollReplies from the caller's thread.
+// Any number of gets may be in flight at once.
+#define ZU_REPLY_OK    0   // reply payload
+#define ZU_REPLY_ERROR 1   // error reply; payload is the error message
+#define ZU_REPLY_DONE  2   // last event of a request (no payload); none follow for this id
+
+typedef struct ZU_ReplyInfo {
+    uint64_t request_id;   // as returned by ZU_Get
+    int32_t  status;       // ZU_REPLY_*
+    int32_t  offset;       // payload spans [offset, offset + len) of out_buf
+    int32_t  len;
+    int32_t  reserved;
+} ZU_ReplyInfo;
+
+// Declares the querier for `key` ahead of time with its reply timeout (<= 0 selects 3000 ms).
+// Optional: ZU_Get declares it with the default timeout on first use.
+ZU_API int32_t ZU_DeclareQuerier(ZU_NodeHandle node, const char* key, int32_t timeout_ms);
+ZU_API int32_t ZU_RemoveQuerier(ZU_NodeHandle node, const char* key);
+
+// Sends a query to `key` (payload may be null). Returns its request id, or 0 on failure.
+ZU_API uint64_t ZU_Get(ZU_NodeHandle node, const char* key, const char* parameters /* nullable */,
+                       const uint8_t* payload, int32_t len);
+
+// Same, through the streaming querier of `key`: replies are not consolidated, so every
+// reply of a streaming server is queued as soon as it arrives. ZU_DeclareStreamQuerier
+// sets its timeout ahead of time; ZU_RemoveQuerier removes both queriers of a key.
+ZU_API int32_t  ZU_DeclareStreamQuerier(ZU_NodeHandle node, const char* key, int32_t timeout_ms);
+ZU_API uint64_t ZU_GetStream(ZU_NodeHandle node, const char* key, const char* parameters /* nullable */,
+                             const uint8_t* payload, int32_t len);
+
+// Copies up to `max_replies` queued reply events back to back into `out_buf` (`out_cap`
+// bytes), describing each in `out_info`. Returns the number of events copied; if the
+// oldest event's payload alone is larger than `out_cap`, returns -(its size) and consumes nothing.
+ZU_API int32_t ZU_PollReplies(ZU_NodeHandle node, uint8_t* out_buf, int32_t out_cap,
+                              ZU_ReplyInfo* out_info, int32_t max_replies);
+
+// ---- Runtime statistics -----------------------------------------------------
+#define ZU_KIND_PUBLISHER  0
+#define ZU_KIND_SUBSCRIBER 1
+#define ZU_KIND_SERVER     2
+#define ZU_KIND_QUERIER    3
+
+// Counters for one publisher, subscriber or server. Latency is callback time for
+// subscribers and handler-to-reply time for servers; queue_wait is arrival to handler
+// start on pooled servers (nanoseconds; percentiles are log2-bucket upper bounds).
+typedef struct ZU_KeyStats {
+    char     key[128];        // truncated, always NUL-terminated
+    int32_t  kind;            // ZU_KIND_*
+    int32_t  reserved;
+    uint64_t messages;
+    uint64_t bytes;
+    uint64_t errors;
+    uint64_t timeouts;
+    uint64_t dropped;
+    uint64_t latency_count;
+    uint64_t latency_mean_ns;
+    uint64_t latency_p50_ns;
+    uint64_t latency_p90_ns;
+    uint64_t latency_p99_ns;
+    uint64_t latency_max_ns;
+    uint64_t queue_wait_count;
+    uint64_t queue_wait_mean_ns;
+    uint64_t queue_wait_p50_ns;
+    uint64_t queue_wait_p99_ns;
+    uint64_t queue_wait_max_ns;
+    uint64_t cache_hits;      // server queries answered from the reply cache
+    // Compressed payloads sent (publishers) or received (subscribers), their size before and
+    // after compression, and the time spent compressing / decompressing
+    uint64_t compressed;
+    uint64_t compressed_raw_bytes;
+    uint64_t compressed_wire_bytes;
+    uint64_t codec_time_count;
+    uint64_t codec_time_mean_ns;
+    uint64_t codec_time_p99_ns;
+    uint64_t codec_time_max_ns;
+    // Delta-mode publishers / subscribers: keyframes and deltas sent or applied, the full and
+    // encoded size of those deltas, and keyframe requests served or sent
+    uint64_t keyframes;
+    uint64_t deltas;
+    uint64_t delta_raw_bytes;
+    uint64_t delta_wire_bytes;
+    uint64_t keyframe_requests;
+    // Subscribers of stamping publishers: source timestamp to arrival (meaningful across
+    // hosts only with synchronized clocks), lost and out-of-order payloads
+    uint64_t transit_count;
+    uint64_t transit_mean_ns;
+    uint64_t transit_p50_ns;
+    uint64_t transit_p99_ns;
+    uint64_t transit_max_ns;
+    uint64_t gaps;
+    uint64_t reordered;
+} ZU_KeyStats;
+
+// Fills up to `cap` entries of `out` and returns the total number of endpoints on the
+// node (call again with a larger array if it exceeds `cap`), or -1 on invalid handle.
+ZU_API int32_t ZU_GetStats(ZU_NodeHandle node, ZU_KeyStats* out, int32_t cap);
 
 #ifdef __cplusplus
 } // extern "C"
@@ -0,0 +1,82 @@
+// znode_replay.cpp
+// Publishes a recording (see recorder.h) back through Node::publish.
+//   znode_replay <dir> [--speed X | --fast] [--loop N] [--from-ms T]
+// Default timing is the original inter-sample spacing; --speed scales it (2 = twice as
+// fast) and --fast publishes back to back. Prints how far behind schedule it ran.
+#include "recorder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ubicoders_zenoh;
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <dir> [--speed X | --fast] [--loop N] [--from-ms T]\n", argv[0]);
+        return 2;
+    }
+    const std::string dir = argv[1];
+    double speed = 1.0;
+    bool fast = false;
+    int loops = 1;
+    uint64_t from_ms = 0;
+    for (int i = 2; i < argc; ++i) {
+        const std::string a = argv[i];
+        auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : "0"; };
+        if (a == "--speed") speed = std::atof(next());
+        else if (a == "--fast") fast = true;
+        else if (a == "--loop") loops = std::atoi(next());
+        else if (a == "--from-ms") from_ms = std::strtoull(next(), nullptr, 10);
+        else { std::fprintf(stderr, "unknown argument: %s\n", a.c_str()); return 2; }
+    }
+    if (speed <= 0) fast = true;
+
+    LogReader reader(dir);
+    Node node("znode_replay");
+    std::string key;  // reused across records
+    uint64_t published = 0, bytes = 0;
+    std::vector<double> lag_us;
+
+    const auto wall_start = std::chrono::steady_clock::now();
+    for (int loop = 0; loop < loops; ++loop) {
+        LogRecord rec;
+        reader.rewind();
+        if (!reader.next(rec)) break;
+        const uint64_t t0 = rec.timestamp_ns + from_ms * 1000000ull;
+        if (from_ms) {
+            reader.seek(t0);
+            if (!reader.next(rec)) break;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        do {
+            if (!fast) {
+                const auto offset = std::chrono::nanoseconds(
+                    static_cast<int64_t>((rec.timestamp_ns - std::min(rec.timestamp_ns, t0)) / speed));
+                const auto due = start + offset;
+                std::this_thread::sleep_until(due);
+                lag_us.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - due).count());
+            }
+            key.assign(rec.key.data(), rec.key.size());
+            node.publish(key, rec.payload.data, rec.payload.size);
+            ++published;
+            bytes += rec.payload.size;
+        } while (reader.next(rec));
+    }
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+
+    std::printf("published %llu samples (%.1f MB) in %.3f s: %.0f msg/s, %.1f MB/s\n",
+                static_cast<unsigned long long>(published), bytes / 1e6, secs,
+                secs > 0 ? published / secs : 0.0, secs > 0 ? bytes / secs / 1e6 : 0.0);
+    if (!lag_us.empty()) {
+        std::sort(lag_us.begin(), lag_us.end());
+        auto pct = [&](double p) { return lag_us[std::min(lag_us.size() - 1, static_cast<size_t>(p * (lag_us.size() - 1)))]; };
+        std::printf("schedule lag: p50 %.1f us, p99 %.1f us, max %.1f us\n", pct(0.5), pct(0.99), lag_us.back());
+    }
+    return 0;
+}